@@ -0,0 +1,205 @@
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace benchmark {
+/// Synthetic grammar whose instantiation cost grows with its size.
+struct family {
+  std::string name;
+  std::function<std::string(std::size_t)> generate;
+};
+
+struct measurement {
+  bool compiled;
+  double seconds;
+  long peak_kib;
+  std::uintmax_t object_bytes;
+};
+
+std::string symbol(std::size_t index) {
+  return "percy::symbol<'" + std::string(1, static_cast<char>('a' + index % 26)) + "'>";
+}
+
+std::string prologue() { return "#include <percy.hpp>\n\n#include <string_view>\n\n"; }
+
+std::string epilogue() {
+  return "\nbool parse(std::string_view text) {\n"
+         "  return percy::parser<grammar>::parse(percy::input(text)).is_success();\n"
+         "}\n";
+}
+
+/// A sequence of size symbols.
+std::string wide_sequence(std::size_t size) {
+  std::ostringstream out;
+  out << prologue() << "using grammar = percy::sequence<";
+
+  for (std::size_t i = 0; i < size; ++i) {
+    out << (i == 0 ? "" : ", ") << symbol(i);
+  }
+
+  out << ">;\n" << epilogue();
+  return out.str();
+}
+
+/// A choice between size custom rules producing distinct types.
+std::string wide_one_of(std::size_t size) {
+  std::ostringstream out;
+  out << prologue();
+
+  for (std::size_t i = 0; i < size; ++i) {
+    out << "struct token" << i << "_value {\n  char first, second;\n};\n\n"
+        << "struct token" << i << " {\n"
+        << "  using rule = percy::sequence<" << symbol(i / 26) << ", " << symbol(i) << ">;\n\n"
+        << "  constexpr static token" << i << "_value action(char first, char second) {\n"
+        << "    return {first, second};\n  }\n};\n\n";
+  }
+
+  out << "using grammar = percy::one_of<";
+
+  for (std::size_t i = 0; i < size; ++i) {
+    out << (i == 0 ? "" : ", ") << "token" << i;
+  }
+
+  out << ">;\n" << epilogue();
+  return out.str();
+}
+
+/// Parenthesized expressions nested size levels deep, each level a distinct type.
+std::string deep_nesting(std::size_t size) {
+  std::ostringstream out;
+  out << prologue() << "using level0 = percy::symbol<'x'>;\n";
+
+  for (std::size_t i = 1; i <= size; ++i) {
+    out << "using level" << i << " = percy::one_of<percy::symbol<'x'>, percy::sequence<"
+        << "percy::symbol<'('>, level" << i - 1 << ", percy::symbol<')'>>>;\n";
+  }
+
+  out << "using grammar = level" << size << ";\n" << epilogue();
+  return out.str();
+}
+
+/// Repetition of a choice between size keywords.
+std::string many_words(std::size_t size) {
+  std::ostringstream out;
+  out << prologue();
+
+  for (std::size_t i = 0; i < size; ++i) {
+    out << "struct keyword" << i << " {\n"
+        << "  constexpr static std::string_view string = \"kw" << i << "\";\n};\n\n";
+  }
+
+  out << "using grammar = percy::many<percy::either<";
+
+  for (std::size_t i = 0; i < size; ++i) {
+    out << (i == 0 ? "" : ", ") << "percy::word<keyword" << i << ">";
+  }
+
+  out << ">>;\n" << epilogue();
+  return out.str();
+}
+
+/// Compiles the source, measuring the wall time and the peak memory of the compiler.
+measurement compile(const std::vector<std::string> &command, const fs::path &source,
+                    const fs::path &object) {
+  std::vector<std::string> arguments = command;
+  arguments.insert(arguments.end(), {"-c", source.string(), "-o", object.string()});
+
+  std::vector<char *> argv;
+  for (auto &argument : arguments) {
+    argv.push_back(argument.data());
+  }
+  argv.push_back(nullptr);
+
+  auto start = std::chrono::steady_clock::now();
+
+  pid_t pid = fork();
+
+  if (pid < 0) {
+    return {false, 0, 0, 0};
+  }
+
+  if (pid == 0) {
+    execvp(argv[0], argv.data());
+    _exit(127);
+  }
+
+  int status = 0;
+  rusage usage{};
+  wait4(pid, &status, 0, &usage);
+
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    return {false, elapsed.count(), usage.ru_maxrss, 0};
+  }
+
+  return {true, elapsed.count(), usage.ru_maxrss, fs::file_size(object)};
+}
+} // namespace benchmark
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    std::cerr << "usage: " << argv[0] << " <work-directory> <compiler> [compiler-flags...]\n";
+    return 2;
+  }
+
+  fs::path directory = argv[1];
+  std::vector<std::string> command(argv + 2, argv + argc);
+
+  fs::create_directories(directory);
+
+  std::vector<benchmark::family> families = {
+      {"wide_sequence", benchmark::wide_sequence},
+      {"wide_one_of", benchmark::wide_one_of},
+      {"deep_nesting", benchmark::deep_nesting},
+      {"many_words", benchmark::many_words},
+  };
+
+  std::vector<std::size_t> sizes = {8, 16, 32, 64};
+
+  std::ofstream csv(directory / "results.csv");
+  csv << "family,size,seconds,peak_kib,object_bytes\n";
+
+  std::printf("%-14s %6s %10s %12s %14s\n", "family", "size", "seconds", "peak KiB",
+              "object bytes");
+
+  bool all_compiled = true;
+
+  for (const auto &family : families) {
+    for (auto size : sizes) {
+      auto stem = family.name + "_" + std::to_string(size);
+      auto source = directory / (stem + ".cpp");
+      auto object = directory / (stem + ".o");
+
+      std::ofstream(source) << family.generate(size);
+
+      auto result = benchmark::compile(command, source, object);
+
+      if (!result.compiled) {
+        all_compiled = false;
+        std::printf("%-14s %6zu %10s\n", family.name.c_str(), size, "failed");
+        continue;
+      }
+
+      std::printf("%-14s %6zu %10.2f %12ld %14ju\n", family.name.c_str(), size, result.seconds,
+                  result.peak_kib, result.object_bytes);
+
+      csv << family.name << ',' << size << ',' << result.seconds << ',' << result.peak_kib << ','
+          << result.object_bytes << '\n';
+    }
+  }
+
+  return all_compiled ? 0 : 1;
+}
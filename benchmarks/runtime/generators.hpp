@@ -0,0 +1,167 @@
+#ifndef PERCY_BENCHMARKS_GENERATORS
+#define PERCY_BENCHMARKS_GENERATORS
+
+#include <cstddef>
+#include <random>
+#include <string>
+
+namespace benchmark::generator {
+/// Appends pseudo-random inputs of the benchmarked grammars until the text reaches the size.
+class generator {
+  std::mt19937_64 random_;
+  std::string text_;
+
+public:
+  explicit generator(std::uint64_t seed) : random_(seed), text_() {}
+
+  std::string json(std::size_t size) {
+    text_.clear();
+    text_ += "[\n";
+
+    for (bool first = true; text_.size() < size; first = false) {
+      text_ += first ? "  " : ",\n  ";
+      json_value(0);
+    }
+
+    text_ += "\n]\n";
+    return std::move(text_);
+  }
+
+  std::string csv(std::size_t size) {
+    text_.clear();
+
+    while (text_.size() < size) {
+      auto fields = uniform(4, 12);
+
+      for (std::size_t field = 0; field < fields; ++field) {
+        text_ += field == 0 ? "" : ",";
+
+        switch (uniform(0, 2)) {
+        case 0:
+          text_ += std::to_string(uniform(0, 1000000));
+          break;
+        case 1:
+          text_ += "\"" + word() + ", " + word() + "\"";
+          break;
+        default:
+          text_ += word();
+        }
+      }
+
+      text_ += "\n";
+    }
+
+    return std::move(text_);
+  }
+
+  std::string arith(std::size_t size) {
+    text_.clear();
+
+    while (text_.size() < size) {
+      arith_expr(0);
+      text_ += "\n";
+    }
+
+    return std::move(text_);
+  }
+
+  std::string log_lines(std::size_t size) {
+    constexpr const char *levels[] = {"DEBUG", "INFO", "WARN", "ERROR"};
+
+    text_.clear();
+
+    for (std::size_t second = 0; text_.size() < size; ++second) {
+      text_ += "2024-03-" + two_digits(1 + second / 86400 % 28) + "T" +
+               two_digits(second / 3600 % 24) + ":" + two_digits(second / 60 % 60) + ":" +
+               two_digits(second % 60) + "Z ";
+      text_ += levels[uniform(0, 3)];
+      text_ += " [worker-" + std::to_string(uniform(0, 15)) + "] ";
+      text_ += "request " + word() + " handled status=" + std::to_string(uniform(200, 504)) +
+               " took=" + std::to_string(uniform(1, 900)) + "ms\n";
+    }
+
+    return std::move(text_);
+  }
+
+private:
+  std::size_t uniform(std::size_t min, std::size_t max) {
+    return std::uniform_int_distribution<std::size_t>(min, max)(random_);
+  }
+
+  std::string word() {
+    std::string word;
+
+    for (auto length = uniform(3, 10); word.size() < length;) {
+      word += static_cast<char>('a' + uniform(0, 25));
+    }
+
+    return word;
+  }
+
+  static std::string two_digits(std::size_t value) {
+    return std::string(1, static_cast<char>('0' + value / 10)) +
+           static_cast<char>('0' + value % 10);
+  }
+
+  void json_value(std::size_t depth) {
+    auto kind = depth >= 4 ? uniform(2, 5) : uniform(0, 5);
+
+    switch (kind) {
+    case 0: {
+      text_ += "{";
+      for (std::size_t i = 0, n = uniform(0, 5); i < n; ++i) {
+        text_ += i == 0 ? "\"" : ", \"";
+        text_ += word() + "\": ";
+        json_value(depth + 1);
+      }
+      text_ += "}";
+      break;
+    }
+    case 1: {
+      text_ += "[";
+      for (std::size_t i = 0, n = uniform(0, 5); i < n; ++i) {
+        text_ += i == 0 ? "" : ", ";
+        json_value(depth + 1);
+      }
+      text_ += "]";
+      break;
+    }
+    case 2:
+      text_ += "\"" + word() + " \\\"" + word() + "\\\"\"";
+      break;
+    case 3:
+      text_ += std::to_string(uniform(0, 100000)) + "." + std::to_string(uniform(0, 99));
+      break;
+    case 4:
+      text_ += "-" + std::to_string(uniform(0, 100000));
+      break;
+    default:
+      text_ += uniform(0, 1) == 0 ? "true" : "null";
+    }
+  }
+
+  void arith_expr(std::size_t depth) {
+    for (std::size_t i = 0, n = uniform(1, 4); i < n; ++i) {
+      if (i != 0) {
+        text_ += uniform(0, 1) == 0 ? " + " : " - ";
+      }
+
+      for (std::size_t j = 0, m = uniform(1, 3); j < m; ++j) {
+        if (j != 0) {
+          text_ += " * ";
+        }
+
+        if (depth < 3 && uniform(0, 4) == 0) {
+          text_ += "(";
+          arith_expr(depth + 1);
+          text_ += ")";
+        } else {
+          text_ += std::to_string(uniform(0, 9999));
+        }
+      }
+    }
+  }
+};
+} // namespace benchmark::generator
+
+#endif
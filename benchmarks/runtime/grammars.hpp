@@ -0,0 +1,355 @@
+#ifndef PERCY_BENCHMARKS_GRAMMARS
+#define PERCY_BENCHMARKS_GRAMMARS
+
+#include <percy.hpp>
+
+#include <cstdint>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace benchmark::grammar {
+using percy::capture;
+using percy::either;
+using percy::end;
+using percy::eof;
+using percy::fold_many;
+using percy::keywords;
+using percy::many;
+using percy::one_of;
+using percy::range;
+using percy::result;
+using percy::sequence;
+using percy::symbol;
+
+using digit = range<'0', '9'>;
+
+struct zero {
+  constexpr std::size_t operator()() const { return 0; }
+};
+
+/// Adds up the values, or the last elements of the tuple values.
+struct sum {
+  constexpr std::size_t operator()(std::size_t total, std::size_t value) const {
+    return total + value;
+  }
+
+  template <typename... Values>
+  constexpr std::size_t operator()(std::size_t total, const std::tuple<Values...> &value) const {
+    return total + std::get<sizeof...(Values) - 1>(value);
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// JSON documents, producing the number of values. Parses without allocating.
+namespace json {
+struct value;
+
+using ws = capture<many<either<symbol<' '>, symbol<'\t'>, symbol<'\n'>, symbol<'\r'>>>>;
+
+struct string_value {
+  std::string_view text;
+};
+
+struct number_value {
+  std::string_view text;
+};
+
+struct array_value {
+  std::size_t values;
+};
+
+struct object_value {
+  std::size_t values;
+};
+
+struct escaped {
+  using rule = sequence<symbol<'\\'>, range<' ', '~'>>;
+
+  constexpr static char action(char, char escaped) { return escaped; }
+};
+
+struct string {
+  using character = either<range<' ', '!'>, range<'#', '['>, range<']', '~'>, escaped>;
+  using rule = sequence<symbol<'"'>, capture<many<character>>, symbol<'"'>>;
+
+  constexpr static string_value action(char, std::string_view text, char) {
+    return {text};
+  }
+};
+
+struct number {
+  using fraction = sequence<symbol<'.'>, digit, many<digit>>;
+  using rule = capture<sequence<many<symbol<'-'>>, digit, many<digit>, many<fraction>>>;
+
+  constexpr static number_value action(result<std::string_view> parsed) { return {parsed->get()}; }
+};
+
+struct true_keyword {
+  constexpr static std::string_view string = "true";
+};
+
+struct false_keyword {
+  constexpr static std::string_view string = "false";
+};
+
+struct null_keyword {
+  constexpr static std::string_view string = "null";
+};
+
+using literal = keywords<true_keyword, false_keyword, null_keyword>;
+
+struct elements {
+  using rule = sequence<value, fold_many<sequence<ws, symbol<','>, ws, value>, zero, sum>>;
+
+  constexpr static std::size_t action(std::size_t first, std::size_t rest) { return first + rest; }
+};
+
+struct array {
+  using rule = sequence<symbol<'['>, ws, fold_many<elements, zero, sum>, ws, symbol<']'>>;
+
+  constexpr static array_value action(char, std::string_view, std::size_t values, std::string_view,
+                                      char) {
+    return {values};
+  }
+};
+
+struct member {
+  using rule = sequence<string, ws, symbol<':'>, ws, value>;
+
+  constexpr static std::size_t action(string_value, std::string_view, char, std::string_view,
+                                      std::size_t values) {
+    return values + 1;
+  }
+};
+
+struct members {
+  using rule = sequence<member, fold_many<sequence<ws, symbol<','>, ws, member>, zero, sum>>;
+
+  constexpr static std::size_t action(std::size_t first, std::size_t rest) { return first + rest; }
+};
+
+struct object {
+  using rule = sequence<symbol<'{'>, ws, fold_many<members, zero, sum>, ws, symbol<'}'>>;
+
+  constexpr static object_value action(char, std::string_view, std::size_t values, std::string_view,
+                                       char) {
+    return {values};
+  }
+};
+
+struct value {
+  using rule = one_of<object, array, string, number, literal>;
+  using result = std::size_t;
+
+  constexpr static result action(object_value object) { return object.values + 1; }
+  constexpr static result action(array_value array) { return array.values + 1; }
+  constexpr static result action(string_value) { return 1; }
+  constexpr static result action(number_value) { return 1; }
+  constexpr static result action(std::string_view) { return 1; }
+};
+
+struct document {
+  using rule = sequence<ws, value, ws, end>;
+
+  constexpr static std::size_t action(std::string_view, std::size_t values, std::string_view,
+                                      eof) {
+    return values;
+  }
+};
+} // namespace json
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// CSV files, producing the number of fields. Collects the rows and their fields into vectors.
+namespace csv {
+struct quoted {
+  using rule = sequence<symbol<'"'>, capture<many<either<range<' ', '!'>, range<'#', '~'>>>>,
+                        symbol<'"'>>;
+
+  constexpr static std::string_view action(char, std::string_view text, char) {
+    return text;
+  }
+};
+
+struct bare {
+  using rule = capture<many<either<range<' ', '+'>, range<'-', '~'>>>>;
+
+  constexpr static std::string_view action(result<std::string_view> parsed) {
+    return parsed->get();
+  }
+};
+
+using field = either<quoted, bare>;
+
+struct row {
+  using rule = sequence<field, many<sequence<symbol<','>, field>>, symbol<'\n'>>;
+
+  constexpr static std::size_t action(std::string_view,
+                                      std::vector<std::tuple<char, std::string_view>> rest, char) {
+    return rest.size() + 1;
+  }
+};
+
+struct document {
+  using rule = sequence<many<row>, end>;
+
+  constexpr static std::size_t action(std::vector<std::size_t> rows, eof) {
+    std::size_t fields = 0;
+
+    for (auto row_fields : rows) {
+      fields += row_fields;
+    }
+
+    return fields;
+  }
+};
+} // namespace csv
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// Arithmetic expressions over unsigned integers, producing their value modulo 2^64.
+namespace arith {
+struct expr;
+
+using ws = capture<many<symbol<' '>>>;
+
+struct parens_value {
+  std::uint64_t value;
+};
+
+struct number {
+  using rule = capture<sequence<digit, many<digit>>>;
+
+  constexpr static std::uint64_t action(result<std::string_view> parsed) {
+    std::uint64_t value = 0;
+
+    for (auto digit : parsed->get()) {
+      value = value * 10 + static_cast<std::uint64_t>(digit - '0');
+    }
+
+    return value;
+  }
+};
+
+struct parens {
+  using rule = sequence<symbol<'('>, ws, expr, ws, symbol<')'>>;
+
+  constexpr static parens_value action(char, std::string_view, std::uint64_t value,
+                                       std::string_view, char) {
+    return {value};
+  }
+};
+
+struct factor {
+  using rule = one_of<number, parens>;
+  using result = std::uint64_t;
+
+  constexpr static result action(std::uint64_t number) { return number; }
+  constexpr static result action(parens_value parens) { return parens.value; }
+};
+
+struct one {
+  constexpr std::uint64_t operator()() const { return 1; }
+};
+
+struct multiply {
+  template <typename Operation>
+  constexpr std::uint64_t operator()(std::uint64_t product, const Operation &operation) const {
+    return product * std::get<3>(operation);
+  }
+};
+
+/// Sums the operands, negating the subtracted ones.
+struct add {
+  constexpr std::uint64_t operator()() const { return 0; }
+
+  template <typename Operation>
+  constexpr std::uint64_t operator()(std::uint64_t total, const Operation &operation) const {
+    auto operand = std::get<3>(operation);
+    return std::get<1>(operation) == '+' ? total + operand : total - operand;
+  }
+};
+
+struct term {
+  using rule = sequence<factor, fold_many<sequence<ws, symbol<'*'>, ws, factor>, one, multiply>>;
+
+  constexpr static std::uint64_t action(std::uint64_t first, std::uint64_t rest) {
+    return first * rest;
+  }
+};
+
+struct expr {
+  using operation = sequence<ws, either<symbol<'+'>, symbol<'-'>>, ws, term>;
+  using rule = sequence<term, fold_many<operation, add, add>>;
+
+  constexpr static std::uint64_t action(std::uint64_t first, std::uint64_t rest) {
+    return first + rest;
+  }
+};
+
+/// Sums the values of the lines.
+struct total {
+  constexpr std::uint64_t operator()() const { return 0; }
+
+  template <typename Line>
+  constexpr std::uint64_t operator()(std::uint64_t sum, const Line &line) const {
+    return sum + std::get<1>(line);
+  }
+};
+
+struct document {
+  using rule = sequence<fold_many<sequence<ws, expr, ws, symbol<'\n'>>, total, total>, end>;
+
+  constexpr static std::uint64_t action(std::uint64_t sum, eof) { return sum; }
+};
+} // namespace arith
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// Log lines of services, producing the number of errors.
+namespace log_lines {
+struct debug_level {
+  constexpr static std::string_view string = "DEBUG";
+};
+
+struct info_level {
+  constexpr static std::string_view string = "INFO";
+};
+
+struct warn_level {
+  constexpr static std::string_view string = "WARN";
+};
+
+struct error_level {
+  constexpr static std::string_view string = "ERROR";
+};
+
+using timestamp =
+    capture<many<either<digit, symbol<'-'>, symbol<':'>, symbol<'.'>, symbol<'T'>, symbol<'Z'>>>>;
+using level = keywords<debug_level, info_level, warn_level, error_level>;
+using component =
+    sequence<symbol<'['>, capture<many<either<range<'a', 'z'>, digit, symbol<'-'>>>>, symbol<']'>>;
+using message = capture<many<range<' ', '~'>>>;
+
+struct line {
+  using rule = sequence<timestamp, symbol<' '>, level, symbol<' '>, component, symbol<' '>, message,
+                        symbol<'\n'>>;
+
+  constexpr static std::size_t action(std::string_view, char, std::string_view level, char,
+                                      std::tuple<char, std::string_view, char>, char,
+                                      std::string_view, char) {
+    return level == error_level::string ? 1 : 0;
+  }
+};
+
+struct document {
+  using rule = sequence<fold_many<line, zero, sum>, end>;
+
+  constexpr static std::size_t action(std::size_t errors, eof) { return errors; }
+};
+} // namespace log_lines
+} // namespace benchmark::grammar
+
+#endif
@@ -0,0 +1,113 @@
+#include "generators.hpp"
+#include "grammars.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+std::atomic<std::size_t> allocations = 0;
+} // namespace
+
+void *operator new(std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+
+  if (auto memory = std::malloc(size == 0 ? 1 : size)) {
+    return memory;
+  }
+
+  throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t) noexcept { std::free(memory); }
+
+namespace benchmark {
+struct report {
+  std::string name;
+  std::size_t bytes;
+  std::size_t iterations;
+  double seconds;
+  std::size_t allocations;
+  bool succeeded;
+};
+
+/// Parses the text with Rule repeatedly for at least the given time.
+template <typename Rule>
+report run(std::string name, const std::string &text, double min_seconds) {
+  using clock = std::chrono::steady_clock;
+
+  report report{std::move(name), text.size(), 0, 0, 0, true};
+
+  // The first parse warms up the caches and checks the generated input.
+  report.succeeded = percy::parser<Rule>::parse(percy::input(std::string_view(text))).is_success();
+
+  auto allocations_before = allocations.load();
+  auto start = clock::now();
+
+  while (report.succeeded && (report.iterations < 3 || report.seconds < min_seconds)) {
+    auto result = percy::parser<Rule>::parse(percy::input(std::string_view(text)));
+    report.succeeded = result.is_success();
+    report.iterations += 1;
+    report.seconds = std::chrono::duration<double>(clock::now() - start).count();
+  }
+
+  report.allocations = allocations.load() - allocations_before;
+  return report;
+}
+
+void print(const std::vector<report> &reports) {
+  std::printf("{\n  \"benchmarks\": [\n");
+
+  for (std::size_t i = 0; i < reports.size(); ++i) {
+    const auto &report = reports[i];
+    auto iterations = static_cast<double>(report.iterations == 0 ? 1 : report.iterations);
+    auto bytes = static_cast<double>(report.bytes) * iterations;
+
+    std::printf("    {\"name\": \"%s\", \"succeeded\": %s, \"bytes\": %zu, \"iterations\": %zu, "
+                "\"mb_per_s\": %.2f, \"ns_per_byte\": %.3f, \"allocations_per_parse\": %.1f}%s\n",
+                report.name.c_str(), report.succeeded ? "true" : "false", report.bytes,
+                report.iterations, bytes / report.seconds / 1e6, report.seconds * 1e9 / bytes,
+                static_cast<double>(report.allocations) / iterations,
+                i + 1 == reports.size() ? "" : ",");
+  }
+
+  std::printf("  ]\n}\n");
+}
+} // namespace benchmark
+
+int main(int argc, char **argv) {
+  std::size_t size = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4 << 20;
+  double min_seconds = argc > 2 ? std::strtod(argv[2], nullptr) : 1.0;
+
+  benchmark::generator::generator generator(42);
+
+  auto json = generator.json(size);
+  auto csv = generator.csv(size);
+  auto arith = generator.arith(size);
+  auto log_lines = generator.log_lines(size);
+
+  namespace grammar = benchmark::grammar;
+
+  std::vector<benchmark::report> reports = {
+      benchmark::run<grammar::json::document>("json", json, min_seconds),
+      benchmark::run<grammar::csv::document>("csv", csv, min_seconds),
+      benchmark::run<grammar::arith::document>("arith", arith, min_seconds),
+      benchmark::run<grammar::log_lines::document>("log_lines", log_lines, min_seconds),
+  };
+
+  benchmark::print(reports);
+
+  for (const auto &report : reports) {
+    if (!report.succeeded) {
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -24,8 +24,6 @@ struct call {
   const expr *arg2;
 
   constexpr explicit call(char n, const expr *a1, const expr *a2) : name(n), arg1(a1), arg2(a2) {}
-
-  constexpr ~call();
 };
 
 struct expr {
@@ -40,11 +38,7 @@ struct ast {
   const expr *expression;
 
   constexpr explicit ast(const expr *e) : expression(e) {}
-
-  constexpr ~ast() { int x = 0; }
 };
-
-constexpr call::~call() { delete arg1; delete arg2; }
 } // namespace example::ast
 
 #endif
@@ -6,6 +6,11 @@
 #include <percy.hpp>
 
 namespace example::grammar {
+/// Parse context owning the nodes of the syntax tree, in a buffer holding up to 256 expressions.
+struct context : percy::context {
+  percy::fixed_arena<ast::expr, 256> exprs;
+};
+
 using percy::end;
 using percy::eof;
 using percy::one_of;
@@ -31,24 +36,29 @@ struct variable {
 struct call {
   using rule = sequence<range<'a', 'z'>, symbol<'('>, expr, symbol<','>, expr, symbol<')'>>;
 
-  constexpr static auto action(char fun, char l, ast::expr *e1, char comma, ast::expr *e2, char r) {
+  constexpr static auto action(char fun, char l, const ast::expr *e1, char comma,
+                               const ast::expr *e2, char r) {
     return ast::call(fun, e1, e2);
   }
 };
 
 struct expr {
   using rule = one_of<call, literal, variable>;
-  using result = ast::expr *;
+  using result = const ast::expr *;
 
-  constexpr static auto action(ast::call call) { return new ast::expr(call); }
-  constexpr static auto action(ast::literal literal) { return new ast::expr(literal); }
-  constexpr static auto action(ast::variable variable) { return new ast::expr(variable); }
+  constexpr static result action(context &ctx, ast::call call) { return ctx.exprs.make(call); }
+  constexpr static result action(context &ctx, ast::literal literal) {
+    return ctx.exprs.make(literal);
+  }
+  constexpr static result action(context &ctx, ast::variable variable) {
+    return ctx.exprs.make(variable);
+  }
 };
 
 struct top {
   using rule = sequence<expr, end>;
 
-  constexpr static auto action(ast::expr *expr, eof _) { return ast::ast(expr); }
+  constexpr static auto action(const ast::expr *expr, eof _) { return ast::ast(expr); }
 };
 } // namespace example::grammar
 
@@ -5,8 +5,9 @@
 int main() {
   using parser = percy::parser<example::grammar::top>;
 
-  auto exit_code = []() {
-    auto input = percy::input(INPUT_CODE);
+  constexpr auto exit_code = []() {
+    example::grammar::context ctx;
+    auto input = percy::with_context(percy::input(INPUT_CODE), ctx);
     auto result = parser::parse(input);
     return result.is_success() ? 0 : 1;
   }();
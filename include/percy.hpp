@@ -1,10 +1,24 @@
 #ifndef PERCY
 #define PERCY
 
+#include "percy/arena.hpp"
+#include "percy/batch.hpp"
+#include "percy/context.hpp"
+#include "percy/first_set.hpp"
+#include "percy/incremental.hpp"
 #include "percy/input.hpp"
+#include "percy/mapped_file.hpp"
+#include "percy/memo_table.hpp"
+#include "percy/optimize.hpp"
+#include "percy/parallel_many.hpp"
 #include "percy/parser.hpp"
+#include "percy/profiler.hpp"
+#include "percy/push_parser.hpp"
 #include "percy/result.hpp"
 #include "percy/rules.hpp"
+#include "percy/scan.hpp"
+#include "percy/stream_input.hpp"
+#include "percy/thread_pool.hpp"
 #include "percy/type_traits.hpp"
 
 #endif
@@ -0,0 +1,142 @@
+#ifndef PERCY_ARENA
+#define PERCY_ARENA
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace percy {
+/// Bump allocator of nodes that are all released at once, usable in constant evaluation too.
+///
+/// The nodes live in chunks allocated as the arena grows, so its capacity is unbounded. See
+/// fixed_arena for nodes kept inside the arena itself.
+template <typename Node, std::size_t ChunkSize = 64>
+class arena {
+  static_assert(ChunkSize > 0, "The `arena` requires chunks to hold at least one node.");
+
+  std::vector<Node *> chunks_;
+  std::size_t full_;
+  std::size_t used_;
+
+public:
+  constexpr arena() : chunks_(), full_(0), used_(0) {}
+
+  constexpr arena(arena &&other)
+      : chunks_(std::move(other.chunks_)), full_(other.full_), used_(other.used_) {
+    other.chunks_.clear();
+    other.full_ = 0;
+    other.used_ = 0;
+  }
+
+  constexpr arena(const arena &) = delete;
+  constexpr arena &operator=(const arena &) = delete;
+  constexpr arena &operator=(arena &&) = delete;
+
+  constexpr ~arena() {
+    destroy_nodes();
+
+    for (auto chunk : chunks_) {
+      std::allocator<Node>().deallocate(chunk, ChunkSize);
+    }
+  }
+
+  /// Constructs a node owned by the arena.
+  template <typename... Args>
+  constexpr Node *make(Args &&...args) {
+    if (full_ == chunks_.size()) {
+      chunks_.push_back(std::allocator<Node>().allocate(ChunkSize));
+    }
+
+    auto node = std::construct_at(chunks_[full_] + used_, std::forward<Args>(args)...);
+
+    if (++used_ == ChunkSize) {
+      ++full_;
+      used_ = 0;
+    }
+
+    return node;
+  }
+
+  /// Releases all nodes while keeping the memory for the following ones.
+  constexpr void clear() {
+    destroy_nodes();
+    full_ = 0;
+    used_ = 0;
+  }
+
+  constexpr std::size_t size() const { return full_ * ChunkSize + used_; }
+
+private:
+  constexpr void destroy_nodes() {
+    if constexpr (!std::is_trivially_destructible_v<Node>) {
+      for (std::size_t chunk = 0; chunk < full_; ++chunk) {
+        std::destroy_n(chunks_[chunk], ChunkSize);
+      }
+
+      if (full_ < chunks_.size()) {
+        std::destroy_n(chunks_[full_], used_);
+      }
+    }
+  }
+};
+
+/// Bump allocator of at most Capacity nodes kept in a buffer inside the arena, so that making
+/// nodes never allocates memory, in constant evaluation or not. The nodes are released all at once.
+///
+/// Making more nodes than the capacity is a precondition violation. The arena cannot be moved,
+/// since the nodes do not outlive it.
+template <typename Node, std::size_t Capacity>
+class fixed_arena {
+  static_assert(Capacity > 0, "The `fixed_arena` requires a capacity of at least one node.");
+
+  /// Storage of a node, constructed only once the node is made.
+  union slot {
+    char unused;
+    Node node;
+
+    constexpr slot() : unused() {}
+    constexpr ~slot() {}
+  };
+
+  slot slots_[Capacity];
+  std::size_t used_;
+
+public:
+  constexpr fixed_arena() : slots_(), used_(0) {}
+
+  constexpr fixed_arena(const fixed_arena &) = delete;
+  constexpr fixed_arena &operator=(const fixed_arena &) = delete;
+
+  constexpr ~fixed_arena() { destroy_nodes(); }
+
+  /// Constructs a node owned by the arena.
+  template <typename... Args>
+  constexpr Node *make(Args &&...args) {
+    assert(used_ < Capacity && "The arena is full.");
+    return std::construct_at(&slots_[used_++].node, std::forward<Args>(args)...);
+  }
+
+  /// Releases all nodes, making room for as many new ones.
+  constexpr void clear() {
+    destroy_nodes();
+    used_ = 0;
+  }
+
+  constexpr std::size_t size() const { return used_; }
+  constexpr static std::size_t capacity() { return Capacity; }
+
+private:
+  constexpr void destroy_nodes() {
+    if constexpr (!std::is_trivially_destructible_v<Node>) {
+      for (std::size_t index = 0; index < used_; ++index) {
+        std::destroy_at(&slots_[index].node);
+      }
+    }
+  }
+};
+} // namespace percy
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef PERCY_BATCH
+#define PERCY_BATCH
+
+#include "percy/context.hpp"
+#include "percy/input.hpp"
+#include "percy/parser.hpp"
+#include "percy/thread_pool.hpp"
+
+#include <algorithm>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace percy {
+/// Parses batches of independent texts with Rule on its own pool of threads.
+///
+/// Every worker owns a Context it reuses for all the texts it parses. The memo table and the
+/// expectations of the context are cleared before each text, the table keeping its memory.
+/// Anything else the context holds, like arenas owning the nodes of the results, stays until the
+/// batch parser is destroyed or the context gets cleared through for_each_context.
+///
+/// Batches parsed on workers of a pool run on the calling thread with one more context, shared by
+/// all such batches one at a time.
+template <typename Rule, typename Context = context>
+class batch_parser {
+  thread_pool pool_;
+  std::vector<std::unique_ptr<Context>> contexts_;
+  std::unique_ptr<Context> nested_context_;
+  std::mutex nested_mutex_;
+
+public:
+  using result_type = parser_result_t<Rule>;
+
+  explicit batch_parser(std::size_t threads = std::thread::hardware_concurrency())
+      : pool_(threads), contexts_(), nested_context_(std::make_unique<Context>()),
+        nested_mutex_() {
+    for (std::size_t i = 0; i < pool_.size(); ++i) {
+      contexts_.push_back(std::make_unique<Context>());
+    }
+  }
+
+  /// Parses each text of the range, returning the results in the order of the texts.
+  template <typename Range>
+  std::vector<result_type> parse(const Range &texts) {
+    auto count = static_cast<std::size_t>(std::distance(std::begin(texts), std::end(texts)));
+
+    std::vector<std::optional<result_type>> parsed(count);
+
+    // Running on a worker of another pool, waiting for this one could exhaust it.
+    if (thread_pool::is_worker()) {
+      std::lock_guard lock(nested_mutex_);
+      parse_block(texts, 0, count, parsed, *nested_context_);
+      return unwrap(parsed);
+    }
+
+    // Blocks small enough for stealing to balance the load, big enough to amortize the tasks.
+    auto block_size = std::max<std::size_t>(1, count / (pool_.size() * 16));
+
+    std::vector<std::future<void>> blocks;
+
+    for (std::size_t begin = 0; begin < count; begin += block_size) {
+      auto end = std::min(count, begin + block_size);
+
+      blocks.push_back(pool_.submit([this, &texts, &parsed, begin, end] {
+        parse_block(texts, begin, end, parsed, *contexts_[pool_.worker_index()]);
+      }));
+    }
+
+    for (auto &block : blocks) {
+      block.get();
+    }
+
+    return unwrap(parsed);
+  }
+
+  /// Calls the function with the context of each worker, while no batch is being parsed.
+  template <typename Function>
+  void for_each_context(Function function) {
+    for (auto &context : contexts_) {
+      function(*context);
+    }
+
+    function(*nested_context_);
+  }
+
+private:
+  template <typename Range>
+  static void parse_block(const Range &texts, std::size_t begin, std::size_t end,
+                          std::vector<std::optional<result_type>> &parsed, Context &context) {
+    auto text = std::next(std::begin(texts), begin);
+
+    for (auto index = begin; index < end; ++index, ++text) {
+      context.memo().clear();
+      context.expected().clear();
+
+      auto input = with_context(percy::input(std::string_view(*text)), context);
+      parsed[index].emplace(parser<Rule>::parse(input));
+    }
+  }
+
+  static std::vector<result_type> unwrap(std::vector<std::optional<result_type>> &parsed) {
+    std::vector<result_type> results;
+    results.reserve(parsed.size());
+
+    for (auto &result : parsed) {
+      results.push_back(std::move(*result));
+    }
+
+    return results;
+  }
+};
+} // namespace percy
+
+#endif
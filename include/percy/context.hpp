@@ -0,0 +1,79 @@
+#ifndef PERCY_CONTEXT
+#define PERCY_CONTEXT
+
+#include "percy/input_span.hpp"
+#include "percy/memo_table.hpp"
+#include "percy/result.hpp"
+
+#include <utility>
+
+namespace percy {
+/// State shared by all parsers taking part in a single parse.
+class context {
+  memo_table memo_;
+  expectations expected_;
+
+public:
+  constexpr context() = default;
+
+  constexpr memo_table &memo() { return memo_; }
+  constexpr const memo_table &memo() const { return memo_; }
+
+  /// What the terminal rules expected at the furthest location the parse failed at. Failures of
+  /// memoized results are recorded when the results get parsed, not when they are reused.
+  constexpr expectations &expected() { return expected_; }
+  constexpr const expectations &expected() const { return expected_; }
+
+  /// Called when the parse commits at the location, releasing the memoized results before it.
+  constexpr void commit(input_location location) { memo_.release(location); }
+};
+
+/// Input that carries a parse context along with the underlying input.
+template <typename Input, typename Context>
+class context_input {
+  Input input_;
+  Context *context_;
+
+public:
+  constexpr context_input(Input input, Context &context)
+      : input_(std::move(input)), context_(&context) {}
+
+  constexpr char peek() const { return input_.peek(); }
+  constexpr bool ended() const { return input_.ended(); }
+
+  constexpr input_location loc() const { return input_.loc(); }
+
+  template <typename I = Input>
+  constexpr auto remaining() const -> decltype(std::declval<const I &>().remaining()) {
+    return input_.remaining();
+  }
+
+  template <typename I = Input>
+  constexpr auto slice(input_span span) const -> decltype(std::declval<const I &>().slice(span)) {
+    return input_.slice(span);
+  }
+
+  template <typename I = Input>
+  constexpr auto commit() -> decltype(std::declval<I &>().commit()) {
+    return input_.commit();
+  }
+
+  constexpr context_input advanced_by(std::size_t offset) const {
+    return context_input(input_.advanced_by(offset), *context_);
+  }
+
+  constexpr context_input advanced_to(input_location location) const {
+    return context_input(input_.advanced_to(location), *context_);
+  }
+
+  constexpr Context &context() const { return *context_; }
+};
+
+/// Attaches the parse context to the input.
+template <typename Input, typename Context>
+constexpr context_input<Input, Context> with_context(Input input, Context &context) {
+  return context_input<Input, Context>(input, context);
+}
+} // namespace percy
+
+#endif
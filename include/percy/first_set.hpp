@@ -0,0 +1,273 @@
+#ifndef PERCY_FIRST_SET
+#define PERCY_FIRST_SET
+
+#include "percy/rules.hpp"
+#include "percy/type_traits.hpp"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+namespace percy {
+/// Inputs a rule can possibly succeed on, judged by their first character.
+class first_set {
+  std::array<std::uint64_t, 4> chars_;
+  bool end_;
+  bool nullable_;
+
+public:
+  constexpr first_set() : chars_(), end_(false), nullable_(false) {}
+
+  /// The set that admits any input.
+  constexpr static first_set any() {
+    first_set set;
+    set.chars_ = {~std::uint64_t(0), ~std::uint64_t(0), ~std::uint64_t(0), ~std::uint64_t(0)};
+    set.end_ = true;
+    set.nullable_ = true;
+    return set;
+  }
+
+  constexpr static first_set of(char symbol) {
+    first_set set;
+    set.add(symbol);
+    return set;
+  }
+
+  constexpr static first_set of(char begin, char end) {
+    first_set set;
+    for (int symbol = begin; symbol <= end; ++symbol) {
+      set.add(static_cast<char>(symbol));
+    }
+    return set;
+  }
+
+  constexpr static first_set at_end() {
+    first_set set;
+    set.end_ = true;
+    return set;
+  }
+
+  constexpr static first_set empty_match() {
+    first_set set;
+    set.nullable_ = true;
+    return set;
+  }
+
+  /// Whether the rule can succeed without consuming any input.
+  constexpr bool nullable() const { return nullable_; }
+
+  /// Whether the rule can succeed on input starting with the symbol.
+  constexpr bool admits(char symbol) const {
+    auto index = static_cast<unsigned char>(symbol);
+    return nullable_ || (chars_[index / 64] >> (index % 64) & 1) != 0;
+  }
+
+  /// Whether the rule can succeed on ended input.
+  constexpr bool admits_end() const { return nullable_ || end_; }
+
+  /// The set of a choice between this rule and the other one.
+  constexpr first_set operator|(const first_set &other) const {
+    first_set set;
+    for (std::size_t i = 0; i < chars_.size(); ++i) {
+      set.chars_[i] = chars_[i] | other.chars_[i];
+    }
+    set.end_ = end_ || other.end_;
+    set.nullable_ = nullable_ || other.nullable_;
+    return set;
+  }
+
+  /// The set of a sequence of this rule followed by the next one.
+  constexpr first_set then(const first_set &next) const {
+    if (!nullable_) {
+      return *this;
+    }
+
+    auto set = *this | next;
+    set.nullable_ = next.nullable_;
+    return set;
+  }
+
+private:
+  constexpr void add(char symbol) {
+    auto index = static_cast<unsigned char>(symbol);
+    chars_[index / 64] |= std::uint64_t(1) << (index % 64);
+  }
+};
+
+/// The first set of Rule. Rules already being visited make the set conservative.
+template <typename Rule, typename Enabled = void, typename... Visited>
+struct first_set_of {
+  constexpr static first_set value = first_set::any();
+};
+
+template <typename Rule, typename... Visited>
+struct first_set_of<Rule, std::enable_if_t<has_rule_v<Rule>>, Visited...> {
+  constexpr static first_set compute() {
+    if constexpr (has_same_v<Rule, Visited...>) {
+      return first_set::any();
+    } else {
+      return first_set_of<typename Rule::rule, void, Rule, Visited...>::value;
+    }
+  }
+
+  constexpr static first_set value = compute();
+};
+
+template <typename... Visited>
+struct first_set_of<end, void, Visited...> {
+  constexpr static first_set value = first_set::at_end();
+};
+
+/// Rules following a commit marker fail committed on any input they reject, which stops choices
+/// from trying other alternatives. Rules that can commit before consuming input therefore admit any
+/// input, so choices never skip them.
+template <typename... Visited>
+struct first_set_of<commit, void, Visited...> {
+  constexpr static first_set value = first_set::any();
+};
+
+template <char Symbol, typename... Visited>
+struct first_set_of<symbol<Symbol>, void, Visited...> {
+  constexpr static first_set value = first_set::of(Symbol);
+};
+
+template <char Begin, char End, typename... Visited>
+struct first_set_of<range<Begin, End>, void, Visited...> {
+  constexpr static first_set value = first_set::of(Begin, End);
+};
+
+template <typename StringProvider, typename... Visited>
+struct first_set_of<word<StringProvider>, void, Visited...> {
+  constexpr static first_set value = StringProvider::string.empty()
+                                         ? first_set::empty_match()
+                                         : first_set::of(StringProvider::string[0]);
+};
+
+template <typename... StringProviders, typename... Visited>
+struct first_set_of<keywords<StringProviders...>, void, Visited...> {
+  constexpr static first_set value = (first_set_of<word<StringProviders>, void, Visited...>::value |
+                                      ...);
+};
+
+template <typename Rule, typename... FollowingRules, typename... Visited>
+struct first_set_of<sequence<Rule, FollowingRules...>, void, Visited...> {
+  constexpr static first_set compute() {
+    auto set = first_set_of<Rule, void, Visited...>::value;
+    ((set = set.then(first_set_of<FollowingRules, void, Visited...>::value)), ...);
+    return set;
+  }
+
+  constexpr static first_set value = compute();
+};
+
+template <typename Rule, typename... AlternativeRules, typename... Visited>
+struct first_set_of<either<Rule, AlternativeRules...>, void, Visited...> {
+  constexpr static first_set value = (first_set_of<Rule, void, Visited...>::value | ... |
+                                      first_set_of<AlternativeRules, void, Visited...>::value);
+};
+
+template <typename Rule, typename... AlternativeRules, typename... Visited>
+struct first_set_of<one_of<Rule, AlternativeRules...>, void, Visited...> {
+  constexpr static first_set value = (first_set_of<Rule, void, Visited...>::value | ... |
+                                      first_set_of<AlternativeRules, void, Visited...>::value);
+};
+
+template <typename Rule, typename... Visited>
+struct first_set_of<many<Rule>, void, Visited...> {
+  constexpr static first_set value =
+      first_set_of<Rule, void, Visited...>::value | first_set::empty_match();
+};
+
+template <typename Rule, typename Init, typename Step, typename... Visited>
+struct first_set_of<fold_many<Rule, Init, Step>, void, Visited...> {
+  constexpr static first_set value = first_set_of<many<Rule>, void, Visited...>::value;
+};
+
+template <typename Rule, typename Delimiter, typename... Visited>
+struct first_set_of<parallel_many<Rule, Delimiter>, void, Visited...> {
+  constexpr static first_set value = first_set_of<many<Rule>, void, Visited...>::value;
+};
+
+template <typename Rule, typename... Visited>
+struct first_set_of<memo<Rule>, void, Visited...> {
+  constexpr static first_set value = first_set_of<Rule, void, Visited...>::value;
+};
+
+template <typename Rule, typename... Visited>
+struct first_set_of<capture<Rule>, void, Visited...> {
+  constexpr static first_set value = first_set_of<Rule, void, Visited...>::value;
+};
+
+template <typename Rule, typename... Visited>
+struct first_set_of<and_<Rule>, void, Visited...> {
+  constexpr static first_set value = first_set_of<Rule, void, Visited...>::value;
+};
+
+template <typename Rule, typename... Visited>
+struct first_set_of<not_<Rule>, void, Visited...> {
+  constexpr static first_set value = first_set::empty_match();
+};
+
+template <typename Operand, typename... Levels, typename... Visited>
+struct first_set_of<operators<Operand, Levels...>, void, Visited...> {
+  constexpr static first_set value = first_set_of<Operand, void, Visited...>::value;
+};
+
+/// The first set of Rule.
+template <typename Rule>
+constexpr inline first_set first_set_of_v = first_set_of<Rule>::value;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// Jump table of alternatives that can succeed on the next input symbol.
+template <typename... Rules>
+class choice_dispatch {
+  using mask_type = std::uint64_t;
+
+  constexpr static bool enabled = sizeof...(Rules) <= 64;
+
+  constexpr static std::array<mask_type, 257> make_table() {
+    std::array<mask_type, 257> table{};
+
+    if constexpr (enabled) {
+      std::array<first_set, sizeof...(Rules)> sets = {first_set_of_v<Rules>...};
+
+      for (std::size_t index = 0; index < sets.size(); ++index) {
+        for (int symbol = 0; symbol < 256; ++symbol) {
+          if (sets[index].admits(static_cast<char>(symbol))) {
+            table[symbol] |= mask_type(1) << index;
+          }
+        }
+
+        if (sets[index].admits_end()) {
+          table[256] |= mask_type(1) << index;
+        }
+      }
+    }
+
+    return table;
+  }
+
+  constexpr static std::array<mask_type, 257> table_ = make_table();
+
+public:
+  /// Bit mask of the alternatives worth trying on the input.
+  template <typename Input>
+  constexpr static mask_type viable(const Input &input) {
+    if constexpr (!enabled) {
+      return ~mask_type(0);
+    } else if (input.ended()) {
+      return table_[256];
+    } else {
+      return table_[static_cast<unsigned char>(input.peek())];
+    }
+  }
+
+  /// The alternative at the lowest index of the mask, if it is the only one.
+  constexpr static std::size_t single(mask_type mask) {
+    return mask != 0 && (mask & (mask - 1)) == 0 ? std::countr_zero(mask) : sizeof...(Rules);
+  }
+};
+} // namespace percy
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef PERCY_INCREMENTAL
+#define PERCY_INCREMENTAL
+
+#include "percy/context.hpp"
+#include "percy/input_span.hpp"
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace percy {
+/// Replacement of the removed characters at the offset by the inserted text.
+struct edit {
+  std::size_t offset;
+  std::size_t removed;
+  std::string_view inserted;
+
+  constexpr void apply(std::string &text) const { text.replace(offset, removed, inserted); }
+};
+
+/// Parse context whose memoized results survive edits of the parsed text.
+///
+/// Parsing the edited text again only parses the memoized rules whose examined input, lookahead
+/// included, was touched by the edit. Memoized values are reused as they are, so memoized rules
+/// must not produce values referring to the text or to input locations.
+class incremental_context : public context {
+  std::size_t examined_;
+
+public:
+  constexpr incremental_context() : context(), examined_(0) {}
+
+  /// The end of the input examined by the rule being parsed.
+  constexpr std::size_t examined() const { return examined_; }
+  constexpr void set_examined(std::size_t extent) { examined_ = extent; }
+  constexpr void examine(std::size_t extent) { examined_ = std::max(examined_, extent); }
+
+  /// Keeps the memoized results on commits, since later parses of the edited text reuse them.
+  constexpr void commit(input_location) {}
+
+  /// Adjusts the memoized results to the edit of the text. The expectations start over, so after an
+  /// incremental parse they cover only the failures parsed again.
+  constexpr void apply(const edit &change) {
+    memo().apply_edit(change.offset, change.removed, change.inserted.length());
+    expected().clear();
+    examined_ = 0;
+  }
+};
+
+/// Input recording the extent of the examined input in its incremental context.
+///
+/// It does not expose the remaining content, since parsers could examine it without being noticed.
+template <typename Input, typename Context>
+class incremental_input {
+  Input input_;
+  Context *context_;
+
+public:
+  constexpr incremental_input(Input input, Context &context) : input_(input), context_(&context) {}
+
+  constexpr char peek() const {
+    context_->examine(input_.loc().get() + 1);
+    return input_.peek();
+  }
+
+  constexpr bool ended() const {
+    context_->examine(input_.loc().get() + 1);
+    return input_.ended();
+  }
+
+  constexpr input_location loc() const { return input_.loc(); }
+
+  template <typename I = Input>
+  constexpr auto slice(input_span span) const -> decltype(std::declval<const I &>().slice(span)) {
+    return input_.slice(span);
+  }
+
+  constexpr incremental_input advanced_by(std::size_t offset) const {
+    return incremental_input(input_.advanced_by(offset), *context_);
+  }
+
+  constexpr incremental_input advanced_to(input_location location) const {
+    return incremental_input(input_.advanced_to(location), *context_);
+  }
+
+  constexpr Context &context() const { return *context_; }
+
+  constexpr std::size_t examined() const { return context_->examined(); }
+  constexpr void set_examined(std::size_t extent) const { context_->set_examined(extent); }
+  constexpr void examine(std::size_t extent) const { context_->examine(extent); }
+};
+
+/// Attaches the incremental parse context to the input.
+template <typename Input, typename Context>
+constexpr incremental_input<Input, Context> with_incremental_context(Input input,
+                                                                     Context &context) {
+  return incremental_input<Input, Context>(input, context);
+}
+} // namespace percy
+
+#endif
@@ -22,6 +22,16 @@ public:
 
   constexpr input_location loc() const { return input_location(cursor_); }
 
+  /// The content not consumed yet.
+  constexpr std::string_view remaining() const {
+    return cursor_ < content_.length() ? content_.substr(cursor_) : std::string_view();
+  }
+
+  /// The content covered by the span.
+  constexpr std::string_view slice(input_span span) const {
+    return content_.substr(span.begin().get(), span.end().get() - span.begin().get());
+  }
+
   constexpr input advanced_by(std::size_t offset) const {
     return input(content_, cursor_ + offset);
   }
@@ -1,6 +1,8 @@
 #ifndef PERCY_INPUT_SPAN
 #define PERCY_INPUT_SPAN
 
+#include <cstddef>
+
 namespace percy {
 class input_location {
   std::size_t location_;
@@ -0,0 +1,86 @@
+#ifndef PERCY_MAPPED_FILE
+#define PERCY_MAPPED_FILE
+
+#include "percy/input.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace percy {
+/// Read-only memory mapping of a file. Views into its content stay valid while the mapping lives.
+class mapped_file {
+  const char *data_;
+  std::size_t size_;
+
+  mapped_file(const char *data, std::size_t size) : data_(data), size_(size) {}
+
+public:
+  /// Maps the file at the path, hinting the kernel that it is read sequentially.
+  static std::optional<mapped_file> open(const char *path) {
+    int descriptor = ::open(path, O_RDONLY | O_CLOEXEC);
+
+    if (descriptor < 0) {
+      return std::nullopt;
+    }
+
+    struct stat status {};
+
+    if (::fstat(descriptor, &status) != 0) {
+      ::close(descriptor);
+      return std::nullopt;
+    }
+
+    auto size = static_cast<std::size_t>(status.st_size);
+
+    if (size == 0) {
+      ::close(descriptor);
+      return mapped_file(nullptr, 0);
+    }
+
+    void *data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor);
+
+    if (data == MAP_FAILED) {
+      return std::nullopt;
+    }
+
+    ::madvise(data, size, MADV_SEQUENTIAL);
+
+    return mapped_file(static_cast<const char *>(data), size);
+  }
+
+  mapped_file(mapped_file &&other) noexcept
+      : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+
+  mapped_file &operator=(mapped_file &&other) noexcept {
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    return *this;
+  }
+
+  mapped_file(const mapped_file &) = delete;
+  mapped_file &operator=(const mapped_file &) = delete;
+
+  ~mapped_file() {
+    if (data_ != nullptr) {
+      ::munmap(const_cast<char *>(data_), size_);
+    }
+  }
+
+  std::string_view content() const { return std::string_view(data_, size_); }
+
+  /// Input reading the mapped content.
+  percy::input input() const { return percy::input(content()); }
+};
+} // namespace percy
+#endif
+
+#endif
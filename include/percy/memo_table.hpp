@@ -0,0 +1,319 @@
+#ifndef PERCY_MEMO_TABLE
+#define PERCY_MEMO_TABLE
+
+#include "percy/input_span.hpp"
+#include "percy/result.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace percy {
+/// Unique address identifying a rule at compile-time as well as at run-time.
+template <typename Rule>
+struct rule_key {
+  constexpr static char value = 0;
+};
+
+/// Results of rules already parsed at given input locations.
+///
+/// Each result remembers the end of the input examined to produce it, lookahead included. After an
+/// edit of the text, results that examined nothing the edit touched are kept and moved along.
+///
+/// Rules being parsed hold a seed result, a failure at first. Invocations of such a rule at the
+/// same location are left recursive and get the seed, which the rule then grows. The results of the
+/// rules in between depend on the seed, so they are not kept.
+class memo_table {
+public:
+  /// Extent of results whose examined input is not known.
+  constexpr static std::size_t unknown_extent = std::numeric_limits<std::size_t>::max();
+
+private:
+  struct entry {
+    const void *rule;
+    std::size_t location;
+    std::size_t examined;
+    entry *next;
+    bool active;
+    bool recursive;
+    bool involved;
+
+    constexpr entry(const void *r, std::size_t l, std::size_t e, entry *n)
+        : rule(r), location(l), examined(e), next(n), active(false), recursive(false),
+          involved(false) {}
+
+    constexpr virtual ~entry() = default;
+
+    constexpr virtual void shift(std::size_t removed, std::size_t inserted) {
+      location = location - removed + inserted;
+
+      if (examined != unknown_extent) {
+        examined = examined - removed + inserted;
+      }
+    }
+  };
+
+  template <typename Node>
+  constexpr static result<Node> shift_result(result<Node> value, std::size_t removed,
+                                             std::size_t inserted) {
+    return shifted(std::move(value), removed, inserted);
+  }
+
+  /// Values other than results carry no locations.
+  template <typename Value>
+  constexpr static Value shift_result(Value value, std::size_t, std::size_t) {
+    return value;
+  }
+
+  template <typename Result>
+  struct typed_entry : entry {
+    Result result;
+
+    constexpr typed_entry(const void *r, std::size_t l, std::size_t e, entry *n, Result res)
+        : entry(r, l, e, n), result(std::move(res)) {}
+
+    constexpr ~typed_entry() override {}
+
+    constexpr void shift(std::size_t removed, std::size_t inserted) override {
+      entry::shift(removed, inserted);
+      result = shift_result(std::move(result), removed, inserted);
+    }
+  };
+
+  std::vector<entry *> buckets_;
+  std::size_t size_;
+  std::vector<entry *> active_;
+  std::size_t released_;
+
+public:
+  constexpr memo_table() : buckets_(16, nullptr), size_(0), active_(), released_(0) {}
+
+  constexpr memo_table(const memo_table &) = delete;
+  constexpr memo_table &operator=(const memo_table &) = delete;
+
+  constexpr ~memo_table() { clear(); }
+
+  /// The memoized result of Rule at given location, or null if there is none.
+  /// Also stores the extent of the examined input of the result, if there is one.
+  ///
+  /// Finding the seed of a rule being parsed marks the rule left recursive.
+  template <typename Rule, typename Result>
+  constexpr const Result *find(input_location location, std::size_t *examined = nullptr) {
+    auto found = lookup(&rule_key<Rule>::value, location.get());
+
+    if (!found) {
+      return nullptr;
+    }
+
+    if (found->active) {
+      recurse(found);
+    }
+
+    if (examined) {
+      *examined = found->examined;
+    }
+
+    return &static_cast<typed_entry<Result> *>(found)->result;
+  }
+
+  template <typename Rule, typename Result>
+  constexpr const Result *find(input_location location, std::size_t *examined = nullptr) const {
+    auto found = lookup(&rule_key<Rule>::value, location.get());
+
+    if (!found) {
+      return nullptr;
+    }
+
+    if (examined) {
+      *examined = found->examined;
+    }
+
+    return &static_cast<typed_entry<Result> *>(found)->result;
+  }
+
+  /// Memoizes the result of Rule at given location, produced by examining the input up to extent.
+  template <typename Rule, typename Result>
+  constexpr const Result &insert(input_location location, Result result,
+                                 std::size_t examined = unknown_extent) {
+    return emplace(&rule_key<Rule>::value, location.get(), examined, std::move(result))->result;
+  }
+
+  /// Starts parsing Rule at given location, memoizing the seed of its left recursive invocations.
+  /// Rules entered last are left first.
+  template <typename Rule, typename Result>
+  constexpr void enter(input_location location, Result seed) {
+    auto item = emplace(&rule_key<Rule>::value, location.get(), location.get(), std::move(seed));
+    item->active = true;
+    active_.push_back(item);
+  }
+
+  /// Whether the rule entered last was invoked left recursively.
+  constexpr bool recursive() const { return active_.back()->recursive; }
+
+  /// Replaces the seed of the rule entered last by a grown one.
+  template <typename Result>
+  constexpr void grow(Result seed) {
+    static_cast<typed_entry<Result> *>(active_.back())->result = std::move(seed);
+  }
+
+  /// Leaves the rule entered last, memoizing its result unless it depends on the seed of another
+  /// rule still being parsed.
+  template <typename Result>
+  constexpr Result leave(Result result, std::size_t examined = unknown_extent) {
+    auto item = static_cast<typed_entry<Result> *>(active_.back());
+    active_.pop_back();
+
+    if (item->involved) {
+      erase(item);
+      return result;
+    }
+
+    item->result = std::move(result);
+    item->examined = examined;
+    item->active = false;
+    return item->result;
+  }
+
+  /// Adjusts the results to the replacement of removed characters at offset by inserted ones.
+  /// Results that examined the replaced characters are dropped, those after them are moved.
+  constexpr void apply_edit(std::size_t offset, std::size_t removed, std::size_t inserted) {
+    std::vector<entry *> old_buckets(buckets_.size(), nullptr);
+    old_buckets.swap(buckets_);
+
+    for (auto head : old_buckets) {
+      while (head) {
+        auto next = head->next;
+
+        if (head->examined <= offset || head->location >= offset + removed) {
+          if (head->examined > offset) {
+            head->shift(removed, inserted);
+          }
+
+          auto &new_head = buckets_[bucket(head->location)];
+          head->next = new_head;
+          new_head = head;
+        } else {
+          delete head;
+          --size_;
+        }
+
+        head = next;
+      }
+    }
+  }
+
+  /// Releases the results before the location. They get dropped once the table fills up, instead of
+  /// growing it. Dropped results are parsed again if needed.
+  constexpr void release(input_location location) {
+    released_ = std::max(released_, location.get());
+  }
+
+  constexpr std::size_t size() const { return size_; }
+
+  constexpr void clear() {
+    for (auto &head : buckets_) {
+      while (head) {
+        auto next = head->next;
+        delete head;
+        head = next;
+      }
+    }
+
+    size_ = 0;
+    released_ = 0;
+  }
+
+private:
+  template <typename Result>
+  constexpr typed_entry<Result> *emplace(const void *rule, std::size_t location,
+                                         std::size_t examined, Result result) {
+    // The table grows unless dropping released results frees at least half of it.
+    if (size_ >= buckets_.size()) {
+      drop_released();
+
+      if (size_ >= buckets_.size() / 2) {
+        rehash(buckets_.size() * 2);
+      }
+    }
+
+    auto &head = buckets_[bucket(location)];
+    auto item = new typed_entry<Result>(rule, location, examined, head, std::move(result));
+    head = item;
+    ++size_;
+
+    return item;
+  }
+
+  constexpr entry *lookup(const void *rule, std::size_t location) const {
+    for (auto it = buckets_[bucket(location)]; it; it = it->next) {
+      if (it->rule == rule && it->location == location) {
+        return it;
+      }
+    }
+
+    return nullptr;
+  }
+
+  /// Marks the rule left recursive and the rules parsed since it as depending on its seed.
+  constexpr void recurse(entry *rule) {
+    rule->recursive = true;
+
+    for (auto it = active_.rbegin(); it != active_.rend() && *it != rule; ++it) {
+      (*it)->involved = true;
+    }
+  }
+
+  constexpr void drop_released() {
+    if (released_ == 0) {
+      return;
+    }
+
+    for (auto &head : buckets_) {
+      for (auto *it = &head; *it;) {
+        auto item = *it;
+
+        if (item->location < released_ && !item->active) {
+          *it = item->next;
+          delete item;
+          --size_;
+        } else {
+          it = &item->next;
+        }
+      }
+    }
+  }
+
+  constexpr void erase(entry *item) {
+    for (auto *it = &buckets_[bucket(item->location)]; *it; it = &(*it)->next) {
+      if (*it == item) {
+        *it = item->next;
+        delete item;
+        --size_;
+        return;
+      }
+    }
+  }
+
+  constexpr std::size_t bucket(std::size_t location) const {
+    return location & (buckets_.size() - 1);
+  }
+
+  constexpr void rehash(std::size_t bucket_count) {
+    std::vector<entry *> old_buckets(bucket_count, nullptr);
+    old_buckets.swap(buckets_);
+
+    for (auto head : old_buckets) {
+      while (head) {
+        auto next = head->next;
+        auto &new_head = buckets_[bucket(head->location)];
+        head->next = new_head;
+        new_head = head;
+        head = next;
+      }
+    }
+  }
+};
+} // namespace percy
+
+#endif
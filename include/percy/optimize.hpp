@@ -0,0 +1,624 @@
+#ifndef PERCY_OPTIMIZE
+#define PERCY_OPTIMIZE
+
+#include "percy/first_set.hpp"
+#include "percy/parser.hpp"
+#include "percy/rules.hpp"
+#include "percy/scan.hpp"
+#include "percy/type_traits.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace percy {
+/// Rules produced by the optimizer. Each produces the same values as the rule it replaces.
+
+/// A single character admitted by Rule, a choice between character classes, checked at once.
+template <typename Rule>
+struct char_set {};
+
+/// A run of symbols of a sequence matched at once. Each symbol stays a value of the sequence.
+template <char... Symbols>
+struct symbols {};
+
+/// A sequence containing runs of symbols.
+template <typename Rule, typename... FollowingRules>
+struct spliced_sequence {};
+
+/// A choice between sequences sharing the sequence Prefix. The prefix is parsed once, followed by
+/// Tails, the choice between the rest of the sequences.
+template <typename Prefix, typename Tails>
+struct factored {};
+
+template <typename Rule>
+struct optimized_rule;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename Rule, typename Enabled = void>
+struct optimize {
+  using type = Rule;
+};
+
+/// Rule rewritten to parse faster while producing the same values. The rewrite flattens nested
+/// choices, merges choices between character classes into a single lookup, left-factors choices
+/// between sequences with a common prefix and matches runs of symbols in sequences at once.
+///
+/// Custom rules get optimized lazily as they are parsed, so recursive grammars are supported.
+template <typename Rule>
+using optimize_t = typename optimize<Rule>::type;
+
+/// Custom Rule whose rule is optimized, keeping its actions.
+template <typename Rule>
+struct optimized_rule : Rule {
+  using rule = optimize_t<typename Rule::rule>;
+};
+
+namespace detail {
+template <typename... Rules>
+struct rule_list {};
+
+template <typename... Lists>
+struct concat;
+
+template <>
+struct concat<> {
+  using type = rule_list<>;
+};
+
+template <typename... Rules>
+struct concat<rule_list<Rules...>> {
+  using type = rule_list<Rules...>;
+};
+
+template <typename... Rules, typename... OtherRules, typename... Lists>
+struct concat<rule_list<Rules...>, rule_list<OtherRules...>, Lists...>
+    : concat<rule_list<Rules..., OtherRules...>, Lists...> {};
+
+template <typename List>
+struct list_size;
+
+template <typename... Rules>
+struct list_size<rule_list<Rules...>> {
+  constexpr static std::size_t value = sizeof...(Rules);
+};
+
+template <std::size_t Index, typename List>
+struct list_element;
+
+template <std::size_t Index, typename... Rules>
+struct list_element<Index, rule_list<Rules...>> {
+  using type = at_index_t<Index, Rules...>;
+};
+
+template <std::size_t Index, typename List>
+using list_element_t = typename list_element<Index, List>::type;
+
+/// Count rules of List starting at Offset.
+template <std::size_t Offset, std::size_t Count, typename List,
+          typename Indices = std::make_index_sequence<Count>>
+struct slice;
+
+template <std::size_t Offset, std::size_t Count, typename List, std::size_t... Indices>
+struct slice<Offset, Count, List, std::index_sequence<Indices...>> {
+  using type = rule_list<list_element_t<Offset + Indices, List>...>;
+};
+
+template <std::size_t Offset, std::size_t Count, typename List>
+using slice_t = typename slice<Offset, Count, List>::type;
+
+template <typename List>
+struct as_sequence;
+
+template <typename... Rules>
+struct as_sequence<rule_list<Rules...>> {
+  using type = sequence<Rules...>;
+};
+
+template <typename List>
+using as_sequence_t = typename as_sequence<List>::type;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// The alternatives of Rule with nested choices flattened.
+template <typename Rule>
+struct alternatives {
+  using type = rule_list<Rule>;
+};
+
+template <typename... Rules>
+struct alternatives<either<Rules...>> : concat<typename alternatives<Rules>::type...> {};
+
+template <typename Rule>
+struct sequence_rules {
+  constexpr static bool is_sequence = false;
+};
+
+template <typename... Rules>
+struct sequence_rules<sequence<Rules...>> {
+  constexpr static bool is_sequence = true;
+  using type = rule_list<Rules...>;
+};
+
+/// The length of the prefix shared by the rule lists, leaving at least one rule of each list out.
+///
+/// The prefix neither contains a commit marker nor stops right before one, since the choice between
+/// the rests would skip rests starting with the marker on inputs they cannot start with.
+template <std::size_t Index, std::size_t Limit, typename List, typename... Lists>
+constexpr std::size_t common_prefix_length() {
+  if constexpr (Index == Limit) {
+    return Index;
+  } else {
+    using rule = list_element_t<Index, List>;
+
+    constexpr bool shared = (std::is_same_v<rule, list_element_t<Index, Lists>> && ...);
+    constexpr bool committing =
+        std::is_same_v<rule, commit> || std::is_same_v<list_element_t<Index + 1, List>, commit> ||
+        (std::is_same_v<list_element_t<Index + 1, Lists>, commit> || ...);
+
+    if constexpr (shared && !committing) {
+      return common_prefix_length<Index + 1, Limit, List, Lists...>();
+    } else {
+      return Index;
+    }
+  }
+}
+
+template <typename List, typename... Lists>
+constexpr std::size_t common_prefix_length() {
+  constexpr auto shortest = std::min({list_size<List>::value, list_size<Lists>::value...});
+  return common_prefix_length<0, shortest - 1, List, Lists...>();
+}
+
+template <typename Alternatives, typename Enabled = void>
+struct optimize_choice;
+
+template <typename Rule>
+struct optimize_choice<rule_list<Rule>> {
+  using type = optimize_t<Rule>;
+};
+
+/// Left-factors choices between sequences sharing a prefix.
+template <typename... Rules>
+struct optimize_choice<
+    rule_list<Rules...>,
+    std::enable_if_t<(sizeof...(Rules) > 1) && !(is_char_class_v<Rules> && ...) &&
+                     (sequence_rules<Rules>::is_sequence && ...)>> {
+  constexpr static std::size_t prefix_length =
+      common_prefix_length<typename sequence_rules<Rules>::type...>();
+
+  template <std::size_t Length = prefix_length, typename Enabled = void>
+  struct select {
+    using type = either<optimize_t<Rules>...>;
+  };
+
+  template <std::size_t Length>
+  struct select<Length, std::enable_if_t<(Length > 0)>> {
+    using prefix = as_sequence_t<
+        slice_t<0, Length, typename sequence_rules<at_index_t<0, Rules...>>::type>>;
+
+    template <typename List>
+    using tail_t = as_sequence_t<slice_t<Length, list_size<List>::value - Length, List>>;
+
+    using tails = rule_list<tail_t<typename sequence_rules<Rules>::type>...>;
+    using type = factored<optimize_t<prefix>, typename optimize_choice<tails>::type>;
+  };
+
+  using type = typename select<>::type;
+};
+
+template <typename... Rules>
+struct optimize_choice<
+    rule_list<Rules...>,
+    std::enable_if_t<(sizeof...(Rules) > 1) && (is_char_class_v<Rules> && ...)>> {
+  using type = char_set<either<Rules...>>;
+};
+
+template <typename... Rules>
+struct optimize_choice<
+    rule_list<Rules...>,
+    std::enable_if_t<(sizeof...(Rules) > 1) && !(is_char_class_v<Rules> && ...) &&
+                     !(sequence_rules<Rules>::is_sequence && ...)>> {
+  using type = either<optimize_t<Rules>...>;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// Groups runs of symbols of a sequence, optimizing the other rules.
+template <typename Grouped, typename... Rules>
+struct group_runs;
+
+template <typename Grouped, typename Run, typename... Rules>
+struct extend_run;
+
+template <typename... Grouped>
+struct group_runs<rule_list<Grouped...>> {
+  using type = rule_list<Grouped...>;
+  constexpr static bool has_runs = false;
+};
+
+template <typename... Grouped, typename Rule, typename... Rules>
+struct group_runs<rule_list<Grouped...>, Rule, Rules...>
+    : group_runs<rule_list<Grouped..., optimize_t<Rule>>, Rules...> {};
+
+template <typename... Grouped, char Symbol, char NextSymbol, typename... Rules>
+struct group_runs<rule_list<Grouped...>, symbol<Symbol>, symbol<NextSymbol>, Rules...>
+    : extend_run<rule_list<Grouped...>, symbols<Symbol, NextSymbol>, Rules...> {};
+
+template <typename... Grouped, typename Run, typename... Rules>
+struct extend_run<rule_list<Grouped...>, Run, Rules...> {
+  using type = typename group_runs<rule_list<Grouped..., Run>, Rules...>::type;
+  constexpr static bool has_runs = true;
+};
+
+template <typename... Grouped, char... Run, char Symbol, typename... Rules>
+struct extend_run<rule_list<Grouped...>, symbols<Run...>, symbol<Symbol>, Rules...>
+    : extend_run<rule_list<Grouped...>, symbols<Run..., Symbol>, Rules...> {};
+
+template <bool Spliced, typename List>
+struct sequence_of;
+
+template <typename... Rules>
+struct sequence_of<false, rule_list<Rules...>> {
+  using type = sequence<Rules...>;
+};
+
+template <typename... Rules>
+struct sequence_of<true, rule_list<Rules...>> {
+  using type = spliced_sequence<Rules...>;
+};
+
+/// The rules of a sequence with nested sequences spliced in, whose values are not needed.
+template <typename Rule>
+struct flat_rules {
+  using type = rule_list<Rule>;
+};
+
+template <typename... Rules>
+struct flat_rules<sequence<Rules...>> : concat<typename flat_rules<Rules>::type...> {};
+
+template <typename List>
+struct flat_sequence;
+
+template <typename... Rules>
+struct flat_sequence<rule_list<Rules...>> {
+  using type = sequence<Rules...>;
+};
+
+/// Rule optimized for being recognized only, so its value may change.
+template <typename Rule>
+struct optimize_recognized {
+  using type = optimize_t<Rule>;
+};
+
+template <typename... Rules>
+struct optimize_recognized<sequence<Rules...>> {
+  using type =
+      optimize_t<typename flat_sequence<typename flat_rules<sequence<Rules...>>::type>::type>;
+};
+} // namespace detail
+
+template <typename Rule>
+struct optimize<Rule, std::enable_if_t<has_rule_v<Rule>>> {
+  using type = optimized_rule<Rule>;
+};
+
+template <typename... Rules>
+struct optimize<sequence<Rules...>> {
+  using grouped = detail::group_runs<detail::rule_list<>, Rules...>;
+  using type = typename detail::sequence_of<grouped::has_runs, typename grouped::type>::type;
+};
+
+template <typename... Rules>
+struct optimize<either<Rules...>>
+    : detail::optimize_choice<typename detail::alternatives<either<Rules...>>::type> {};
+
+template <typename... Rules>
+struct optimize<one_of<Rules...>> {
+  using type = one_of<optimize_t<Rules>...>;
+};
+
+template <typename Rule>
+struct optimize<many<Rule>> {
+  using type = many<optimize_t<Rule>>;
+};
+
+template <typename Rule, typename Init, typename Step>
+struct optimize<fold_many<Rule, Init, Step>> {
+  using type = fold_many<optimize_t<Rule>, Init, Step>;
+};
+
+template <typename Rule, typename Delimiter>
+struct optimize<parallel_many<Rule, Delimiter>> {
+  using type = parallel_many<optimize_t<Rule>, Delimiter>;
+};
+
+template <typename Rule>
+struct optimize<memo<Rule>> {
+  using type = memo<optimize_t<Rule>>;
+};
+
+template <typename Rule>
+struct optimize<capture<Rule>> {
+  using type = capture<typename detail::optimize_recognized<Rule>::type>;
+};
+
+template <typename Rule>
+struct optimize<and_<Rule>> {
+  using type = and_<typename detail::optimize_recognized<Rule>::type>;
+};
+
+template <typename Rule>
+struct optimize<not_<Rule>> {
+  using type = not_<typename detail::optimize_recognized<Rule>::type>;
+};
+
+template <typename Operand, typename... Levels>
+struct optimize<operators<Operand, Levels...>> {
+  using type = operators<optimize_t<Operand>, Levels...>;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename Rule>
+struct char_class<char_set<Rule>> : char_class<Rule> {};
+
+template <typename... Rules>
+struct is_sequence<spliced_sequence<Rules...>> {
+  constexpr static bool value = true;
+};
+
+template <typename Rule, typename... Visited>
+struct first_set_of<char_set<Rule>, void, Visited...> {
+  constexpr static first_set value = first_set_of<Rule, void, Visited...>::value;
+};
+
+template <char Symbol, char... Symbols, typename... Visited>
+struct first_set_of<symbols<Symbol, Symbols...>, void, Visited...> {
+  constexpr static first_set value = first_set::of(Symbol);
+};
+
+template <typename... Rules, typename... Visited>
+struct first_set_of<spliced_sequence<Rules...>, void, Visited...> {
+  constexpr static first_set value = first_set_of<sequence<Rules...>, void, Visited...>::value;
+};
+
+template <typename Prefix, typename Tails, typename... Visited>
+struct first_set_of<factored<Prefix, Tails>, void, Visited...> {
+  constexpr static first_set value = first_set_of<Prefix, void, Visited...>::value.then(
+      first_set_of<Tails, void, Visited...>::value);
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename Rule>
+struct parser<char_set<Rule>> {
+  using result_type = result<char>;
+
+  template <typename Input>
+  constexpr static result_type parse(Input input) {
+    constexpr auto set = first_set_of_v<Rule>;
+
+    if (!input.ended() && set.admits(input.peek())) {
+      return succeed(input.peek(), {input.loc(), 1});
+    }
+
+    // The choice fails on its own to describe the failure just like before the optimization.
+    return parser<Rule>::parse(input).failure();
+  }
+
+  template <typename Input>
+  constexpr static match_result match(Input input) {
+    return recognize(parse(input));
+  }
+};
+
+template <char... Symbols>
+struct parser<symbols<Symbols...>> {
+  using result_type = result<std::tuple<decltype(Symbols)...>>;
+
+  template <typename Input>
+  constexpr static result_type parse(Input input) {
+    auto matched = matched_length(input);
+
+    if (matched < length) {
+      auto expected = std::string_view(string + matched, 1);
+      return fail_expecting(input.advanced_by(matched), "Expected symbol.", expected);
+    }
+
+    return succeed(std::tuple<decltype(Symbols)...>(Symbols...), {input.loc(), length});
+  }
+
+  template <typename Input>
+  constexpr static match_result match(Input input) {
+    return recognize(parse(input));
+  }
+
+private:
+  constexpr static std::size_t length = sizeof...(Symbols);
+  constexpr static char string[] = {Symbols...};
+
+  template <typename Input>
+  constexpr static std::size_t matched_length(Input input) {
+    constexpr auto run = std::string_view(string, length);
+
+    if constexpr (has_remaining_v<Input>) {
+      auto remaining = input.remaining();
+
+      if (remaining.starts_with(run)) {
+        return length;
+      }
+
+      auto mismatch = std::mismatch(run.begin(), run.end(), remaining.begin(), remaining.end());
+      return static_cast<std::size_t>(mismatch.first - run.begin());
+    }
+
+    std::size_t matched = 0;
+
+    while (matched < length && !input.ended() && input.peek() == run[matched]) {
+      input = input.advanced_by(1);
+      ++matched;
+    }
+
+    return matched;
+  }
+};
+
+namespace detail {
+/// The values a rule of a spliced sequence contributes to the values of the sequence.
+template <typename Rule, typename Enabled = void>
+struct segment {
+  using type = std::tuple<result_value_t<parser_result_t<Rule>>>;
+
+  template <typename Result>
+  constexpr static type values(Result &result) {
+    return type(result->get());
+  }
+};
+
+template <typename Rule>
+struct segment<Rule, std::enable_if_t<is_silent_v<Rule>>> {
+  using type = std::tuple<>;
+
+  template <typename Result>
+  constexpr static type values(Result &) {
+    return type();
+  }
+};
+
+template <char... Symbols>
+struct segment<symbols<Symbols...>> {
+  using type = std::tuple<decltype(Symbols)...>;
+
+  template <typename Result>
+  constexpr static type values(Result &result) {
+    return result->get();
+  }
+};
+} // namespace detail
+
+template <typename Rule, typename... FollowingRules>
+struct parser<spliced_sequence<Rule, FollowingRules...>> {
+  using result_type = result<decltype(std::tuple_cat(
+      std::declval<typename detail::segment<Rule>::type>(),
+      std::declval<typename detail::segment<FollowingRules>::type>()...))>;
+
+  template <typename Input>
+  constexpr static result_type parse(Input input) {
+    return parse_all(std::move(input), std::make_index_sequence<rule_count>());
+  }
+
+  template <typename Input>
+  constexpr static match_result match(Input input) {
+    return parser<sequence<Rule, FollowingRules...>>::match(std::move(input));
+  }
+
+private:
+  constexpr static std::size_t rule_count = 1 + sizeof...(FollowingRules);
+
+  constexpr static std::size_t commit_index = [] {
+    constexpr std::array<bool, rule_count> commits = {std::is_same_v<Rule, commit>,
+                                                      std::is_same_v<FollowingRules, commit>...};
+
+    return std::size_t(std::find(commits.begin(), commits.end(), true) - commits.begin());
+  }();
+
+  /// Storage of the segment of a rule until all rules succeed.
+  template <typename SplicedRule>
+  using slot_t = std::optional<typename detail::segment<SplicedRule>::type>;
+
+  using slots_type = std::tuple<slot_t<Rule>, slot_t<FollowingRules>...>;
+
+  /// Parses the rules one after another into the slots, like parser<sequence> does, splicing the
+  /// segments into the tuple once all rules succeed.
+  template <typename Input, std::size_t... Indices>
+  constexpr static result_type parse_all(Input input, std::index_sequence<Indices...> indices) {
+    auto begin = input.loc();
+
+    slots_type slots;
+    failure_t failure = fail("", begin);
+
+    if (!(parse_next<Indices>(input, slots, failure) && ...)) {
+      return failure;
+    }
+
+    return succeed(take_values(slots, indices), {begin, input.loc()});
+  }
+
+  template <std::size_t Index, typename Input>
+  constexpr static bool parse_next(Input &input, slots_type &slots, failure_t &failure) {
+    using next_rule = at_index_t<Index, Rule, FollowingRules...>;
+
+    auto result = parser<next_rule>::parse(std::move(input));
+
+    if (result.is_failure()) {
+      if constexpr (Index > commit_index) {
+        failure = at_furthest_expectation(input, result.failure()).commit();
+      } else {
+        failure = at_furthest_expectation(input, result.failure());
+      }
+
+      return false;
+    }
+
+    std::get<Index>(slots).emplace(detail::segment<next_rule>::values(result));
+    input = input.advanced_to(result->end());
+    return true;
+  }
+
+  template <std::size_t... Indices>
+  constexpr static result_value_t<result_type> take_values(slots_type &slots,
+                                                           std::index_sequence<Indices...>) {
+    return std::tuple_cat(std::move(*std::get<Indices>(slots))...);
+  }
+};
+
+template <typename Prefix, typename Tails>
+struct parser<factored<Prefix, Tails>> {
+  using result_type = result<decltype(std::tuple_cat(
+      std::declval<result_value_t<parser_result_t<Prefix>>>(),
+      std::declval<result_value_t<parser_result_t<Tails>>>()))>;
+
+  template <typename Input>
+  constexpr static result_type parse(Input input) {
+    auto prefix = parser<Prefix>::parse(input);
+
+    if (prefix.is_failure()) {
+      return prefix.failure();
+    }
+
+    auto tails = parser<Tails>::parse(input.advanced_to(prefix->end()));
+
+    if (tails.is_failure()) {
+      return tails.failure();
+    }
+
+    return succeed(std::tuple_cat(prefix->get(), tails->get()), {input.loc(), tails->end()});
+  }
+
+  template <typename Input>
+  constexpr static match_result match(Input input) {
+    auto prefix = parser<Prefix>::match(input);
+
+    if (prefix.is_failure()) {
+      return prefix;
+    }
+
+    auto tails = parser<Tails>::match(input.advanced_to(prefix->end()));
+
+    if (tails.is_failure()) {
+      return tails;
+    }
+
+    return succeed(recognized{}, {input.loc(), tails->end()});
+  }
+};
+} // namespace percy
+
+#endif
@@ -0,0 +1,208 @@
+#ifndef PERCY_PARALLEL_MANY
+#define PERCY_PARALLEL_MANY
+
+#include "percy/first_set.hpp"
+#include "percy/input.hpp"
+#include "percy/parser.hpp"
+#include "percy/result.hpp"
+#include "percy/rules.hpp"
+#include "percy/thread_pool.hpp"
+
+#include <algorithm>
+#include <future>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+namespace percy {
+/// Parses long plain text inputs in chunks on the shared thread pool, so programs including this
+/// header have to link a threading library, like Threads::Threads in CMake.
+///
+/// Every chunk is checked against a sequential parse before its occurrences are kept. The last
+/// occurrence of a chunk is parsed again on the whole text, and has to end at the boundary of the
+/// chunk as it did on the truncated text. A chunk failing, stopping early or disagreeing at its
+/// boundary makes the rest of the text get parsed sequentially from the beginning of its last
+/// occurrence, the last point both parses agree on.
+template <typename Rule, typename Delimiter>
+struct parser<parallel_many<Rule, Delimiter>> {
+  static_assert(is_char_class_v<Delimiter>, "The delimiter has to be a character class.");
+
+  using result_type = parser_result_t<many<Rule>>;
+
+  /// Plain text inputs are parsed in parallel. Other inputs, constant evaluation and parses running
+  /// on workers of the pool fall back to sequential parsing.
+  template <typename Input>
+  constexpr static result_type parse(Input input) {
+    if constexpr (std::is_same_v<Input, percy::input>) {
+      if (!std::is_constant_evaluated() && !thread_pool::is_worker()) {
+        return parse_parallel(input);
+      }
+    }
+
+    return parser<many<Rule>>::parse(input);
+  }
+
+  template <typename Input>
+  constexpr static match_result match(Input input) {
+    return parser<many<Rule>>::match(input);
+  }
+
+private:
+  constexpr static std::size_t min_chunk_size = 64 * 1024;
+
+  using vector_type = result_value_t<result_type>;
+
+  /// Occurrences parsed from a chunk, where last is the beginning of the last one.
+  struct chunk {
+    vector_type values;
+    input_location last;
+    input_location end;
+    bool committed;
+  };
+
+  /// Chunks see the text up to their end, so their locations are already global.
+  static chunk parse_chunk(percy::input input, std::size_t begin, std::size_t end) {
+    auto text = input.slice({input_location(0), input_location(end)});
+    auto remaining = percy::input(text, begin);
+    chunk parsed = {{}, remaining.loc(), remaining.loc(), false};
+
+    while (true) {
+      auto result = parser<Rule>::parse(remaining);
+
+      if (result.is_failure()) {
+        parsed.committed = is_committed<Rule>(result);
+        break;
+      }
+
+      parsed.last = remaining.loc();
+      parsed.values.push_back(std::move(result->get()));
+      remaining = remaining.advanced_to(result->end());
+    }
+
+    parsed.end = remaining.loc();
+    return parsed;
+  }
+
+  /// Whether the occurrences of the chunk are those a sequential parse finds between its bounds.
+  static bool agrees(percy::input input, chunk &parsed, std::size_t end, bool last_chunk) {
+    if (parsed.committed) {
+      return false;
+    }
+
+    if (last_chunk) {
+      return true;
+    }
+
+    if (parsed.end.get() != end || parsed.values.empty()) {
+      return false;
+    }
+
+    auto occurrence = parser<Rule>::parse(input.advanced_to(parsed.last));
+
+    if (occurrence.is_failure() || occurrence->end().get() != end) {
+      return false;
+    }
+
+    parsed.values.back() = std::move(occurrence->get());
+    return true;
+  }
+
+  static result_type parse_parallel(percy::input input) {
+    auto &pool = thread_pool::shared();
+    auto bounds = split(input, pool.size() * 4);
+
+    if (bounds.size() <= 2) {
+      return parser<many<Rule>>::parse(input);
+    }
+
+    std::vector<std::future<chunk>> chunks;
+
+    for (std::size_t i = 0; i + 1 < bounds.size(); ++i) {
+      auto begin = bounds[i];
+      auto end = bounds[i + 1];
+      chunks.push_back(pool.submit([input, begin, end] { return parse_chunk(input, begin, end); }));
+    }
+
+    auto wait_pending = [&chunks] {
+      for (auto &pending : chunks) {
+        if (pending.valid()) {
+          pending.wait();
+        }
+      }
+    };
+
+    vector_type values;
+
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+      auto parsed = chunks[i].get();
+      auto last_chunk = i + 1 == chunks.size();
+
+      if (agrees(input, parsed, bounds[i + 1], last_chunk)) {
+        values.insert(values.end(), std::make_move_iterator(parsed.values.begin()),
+                      std::make_move_iterator(parsed.values.end()));
+
+        if (last_chunk) {
+          return succeed(std::move(values), {input.loc(), parsed.end});
+        }
+
+        continue;
+      }
+
+      // The pending chunks still read the text, which may not outlive this parse.
+      wait_pending();
+
+      if (!parsed.values.empty()) {
+        parsed.values.pop_back();
+      }
+
+      values.insert(values.end(), std::make_move_iterator(parsed.values.begin()),
+                    std::make_move_iterator(parsed.values.end()));
+
+      auto rest = parser<many<Rule>>::parse(input.advanced_to(parsed.last));
+
+      if (rest.is_failure()) {
+        return rest.failure();
+      }
+
+      auto rest_values = std::move(rest->get());
+
+      values.insert(values.end(), std::make_move_iterator(rest_values.begin()),
+                    std::make_move_iterator(rest_values.end()));
+
+      return succeed(std::move(values), {input.loc(), rest->end()});
+    }
+
+    return succeed(std::move(values), {input.loc(), input.loc()});
+  }
+
+  /// Boundaries of the chunks, placed right after delimiters close to even splits of the text.
+  static std::vector<std::size_t> split(percy::input input, std::size_t max_chunk_count) {
+    constexpr auto delimiter = first_set_of_v<Delimiter>;
+
+    auto text = input.remaining();
+    auto begin = input.loc().get();
+    auto chunk_count = std::min(max_chunk_count, text.size() / min_chunk_size);
+
+    std::vector<std::size_t> bounds = {begin};
+
+    for (std::size_t i = 1; i < chunk_count; ++i) {
+      auto offset = std::max(text.size() * i / chunk_count, bounds.back() - begin);
+
+      while (offset < text.size() && !delimiter.admits(text[offset])) {
+        ++offset;
+      }
+
+      if (offset + 1 >= text.size()) {
+        break;
+      }
+
+      bounds.push_back(begin + offset + 1);
+    }
+
+    bounds.push_back(begin + text.size());
+    return bounds;
+  }
+};
+} // namespace percy
+
+#endif
@@ -1,29 +1,126 @@
 #ifndef PERCY_PARSER
 #define PERCY_PARSER
 
+#include "percy/first_set.hpp"
+#include "percy/input.hpp"
+#include "percy/memo_table.hpp"
 #include "percy/result.hpp"
 #include "percy/rules.hpp"
+#include "percy/scan.hpp"
 
 #include <percy/variant.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
 #include <string_view>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 namespace percy {
+/// Pointer to the parse context the input carries, or nullptr. Custom rules keep it for their
+/// actions instead of the input, which moves on into their rule.
+template <typename Input>
+constexpr auto context_of(const Input &input) {
+  if constexpr (has_context_v<Input>) {
+    return &input.context();
+  } else {
+    return nullptr;
+  }
+}
+
+/// Calls the action of Rule, passing it the parse context of the Input first if the action accepts
+/// one.
+template <typename Rule, typename Input, typename Context, typename... Values>
+constexpr auto invoke_action(Context context, Values &&...values) {
+  if constexpr (accepts_context_v<Rule, Input, Values...>) {
+    return Rule::action(*context, std::forward<Values>(values)...);
+  } else {
+    return Rule::action(std::forward<Values>(values)...);
+  }
+}
+
+/// Parses the custom Rule by Parse. The invocation gets recorded if the input carries a profiler,
+/// otherwise Parse is just called.
+template <typename Rule, typename Input, typename Parse>
+constexpr auto profile(const Input &input, const Parse &parse) {
+  if constexpr (has_profiler_v<Input>) {
+    auto &profiler = input.context().profiler();
+    auto start = profiler.start();
+    auto result = parse();
+
+    auto consumed = result.is_success() ? result->end().get() - result->begin().get() : 0;
+    profiler.template record<Rule>(start, result.is_success(), consumed);
+
+    return result;
+  } else {
+    return parse();
+  }
+}
+
+/// Failure of a terminal rule at the input, recording what it expected there in the parse context
+/// if the input carries one.
+template <typename Input>
+constexpr failure_t fail_expecting(const Input &input, std::string_view message,
+                                   std::string_view expected) {
+  if constexpr (records_expectations_v<Input>) {
+    input.context().expected().record(input.loc(), expected);
+  }
+
+  return fail(message, input.loc());
+}
+
+/// The failure moved to the furthest location the parse recorded expectations at, if the input
+/// carries a context. Repetitions absorb the failures of their last items, so the failure ending a
+/// sequence may lie before the expectations the context reports for it.
+template <typename Input>
+constexpr failure_t at_furthest_expectation(const Input &input, failure_t failure) {
+  if constexpr (records_expectations_v<Input>) {
+    auto location = input.context().expected().loc();
+
+    if (location.get() > failure.loc().get()) {
+      auto moved = fail(failure.message(), location);
+      return failure.committed() ? moved.commit() : moved;
+    }
+  }
+
+  return failure;
+}
+
+/// Whether the result of Rule is a committed failure. Grammars without commit markers never check.
+template <typename Rule, typename Result>
+constexpr bool is_committed(const Result &result) {
+  if constexpr (may_commit_v<Rule>) {
+    return result.committed();
+  } else {
+    return false;
+  }
+}
+
 template <typename Rule, typename Enabled = void>
 struct parser {
   using result_type = result<action_return_t<Rule>>;
 
   template <typename Input>
   constexpr static result_type parse(Input input) {
-    auto raw_result = parser<typename Rule::rule>::parse(input);
+    return profile<Rule>(input, [&input]() -> result_type {
+      auto context = context_of(input);
+      auto raw_result = parser<typename Rule::rule>::parse(std::move(input));
 
-    if (raw_result.is_failure()) {
-      return raw_result.failure();
-    }
+      if (raw_result.is_failure()) {
+        return raw_result.failure();
+      }
 
-    return succeed(Rule::action(raw_result), raw_result->span());
+      auto span = raw_result->span();
+      return succeed(invoke_action<Rule, Input>(context, std::move(raw_result)), span);
+    });
+  }
+
+  template <typename Input>
+  constexpr static match_result match(Input input) {
+    return parser<typename Rule::rule>::match(input);
   }
 };
 
@@ -33,14 +130,26 @@ struct parser<Rule, typename std::enable_if_t<is_one_of_v<typename Rule::rule>>>
 
   template <typename Input>
   constexpr static result_type parse(Input input) {
-    auto raw_result = parser<typename Rule::rule>::parse(input);
+    return profile<Rule>(input, [&input]() -> result_type {
+      auto context = context_of(input);
+      auto raw_result = parser<typename Rule::rule>::parse(std::move(input));
 
-    if (raw_result.is_failure()) {
-      return raw_result.failure();
-    }
+      if (raw_result.is_failure()) {
+        return raw_result.failure();
+      }
+
+      auto visitor = [context](auto &&alternative) {
+        return invoke_action<Rule, Input>(context,
+                                          std::forward<decltype(alternative)>(alternative));
+      };
+
+      return succeed(percy::visit(visitor, raw_result->get()), raw_result->span());
+    });
+  }
 
-    auto visitor = [](auto alternative) { return Rule::action(alternative); };
-    return succeed(percy::visit(visitor, raw_result->get()), raw_result->span());
+  template <typename Input>
+  constexpr static match_result match(Input input) {
+    return parser<typename Rule::rule>::match(input);
   }
 };
 
@@ -50,16 +159,53 @@ struct parser<Rule, std::enable_if_t<is_sequence_v<typename Rule::rule>>> {
 
   template <typename Input>
   constexpr static result_type parse(Input input) {
-    auto raw_result = parser<typename Rule::rule>::parse(input);
+    return profile<Rule>(input, [&input]() -> result_type {
+      auto context = context_of(input);
+      auto raw_result = parser<typename Rule::rule>::parse(std::move(input));
 
-    if (raw_result.is_failure()) {
-      return raw_result.failure();
-    }
+      if (raw_result.is_failure()) {
+        return raw_result.failure();
+      }
+
+      auto action = [context](auto &&...values) {
+        return invoke_action<Rule, Input>(context, std::forward<decltype(values)>(values)...);
+      };
+
+      return succeed(std::apply(action, raw_result->get()), raw_result->span());
+    });
+  }
 
-    auto result0 = raw_result->get();
-    auto result1 = std::apply(Rule::action, result0);
-    auto success = succeed(std::move(result1), raw_result->span());
-    return std::move(success);
+  template <typename Input>
+  constexpr static match_result match(Input input) {
+    return parser<typename Rule::rule>::match(input);
+  }
+};
+
+template <typename Rule>
+struct parser<Rule, std::enable_if_t<is_operators_v<typename Rule::rule>>> {
+  using result_type = result<action_return_t<Rule>>;
+
+  template <typename Input>
+  constexpr static result_type parse(Input input) {
+    using node_type = action_return_t<Rule>;
+    using operators_parser = parser<typename Rule::rule>;
+
+    auto operand = [](Input input) {
+      return parser<typename operators_parser::operand_rule>::parse(input);
+    };
+
+    auto combine = [context = context_of(input)](node_type lhs, char symbol, node_type rhs) {
+      return invoke_action<Rule, Input>(context, std::move(lhs), symbol, std::move(rhs));
+    };
+
+    return profile<Rule>(input, [&] {
+      return operators_parser::template climb<node_type>(std::move(input), operand, combine);
+    });
+  }
+
+  template <typename Input>
+  constexpr static match_result match(Input input) {
+    return parser<typename Rule::rule>::match(input);
   }
 };
 
@@ -72,11 +218,39 @@ struct parser<end> {
   template <typename Input>
   constexpr static result_type parse(Input input) {
     if (!input.ended()) {
-      return fail("Expected end.", input.loc());
+      return fail_expecting(input, "Expected end.", "end of input");
     }
 
     return succeed(eof{}, {input.loc(), input.loc()});
   }
+
+  template <typename Input>
+  constexpr static match_result match(Input input) {
+    return recognize(parse(input));
+  }
+};
+
+template <>
+struct parser<commit> {
+  using result_type = match_result;
+
+  template <typename Input>
+  constexpr static result_type parse(Input input) {
+    if constexpr (has_context_v<Input>) {
+      input.context().commit(input.loc());
+    }
+
+    if constexpr (releases_on_commit_v<Input>) {
+      input.commit();
+    }
+
+    return succeed(recognized{}, {input.loc(), input.loc()});
+  }
+
+  template <typename Input>
+  constexpr static match_result match(Input input) {
+    return parse(input);
+  }
 };
 
 template <char Symbol>
@@ -86,15 +260,24 @@ struct parser<symbol<Symbol>> {
   template <typename Input>
   constexpr static result_type parse(Input input) {
     if (input.ended()) {
-      return fail("Expected symbol.", input.loc());
+      return fail_expecting(input, "Expected symbol.", expected);
     }
 
     if (input.peek() != Symbol) {
-      return fail("Expected symbol.", input.loc());
+      return fail_expecting(input, "Expected symbol.", expected);
     }
 
     return succeed(Symbol, {input.loc(), input.loc() + 1});
   }
+
+  template <typename Input>
+  constexpr static match_result match(Input input) {
+    return recognize(parse(input));
+  }
+
+private:
+  constexpr static char description[] = {Symbol};
+  constexpr static std::string_view expected = std::string_view(description, 1);
 };
 
 template <char Begin, char End>
@@ -104,15 +287,24 @@ struct parser<range<Begin, End>> {
   template <typename Input>
   constexpr static result_type parse(Input input) {
     if (input.ended()) {
-      return fail("Range.", input.loc());
+      return fail_expecting(input, "Range.", expected);
     }
 
     if (auto symbol = input.peek(); Begin <= symbol && symbol <= End) {
       return succeed(std::move(symbol), {input.loc(), 1});
     }
 
-    return fail("Range.", input.loc());
+    return fail_expecting(input, "Range.", expected);
   }
+
+  template <typename Input>
+  constexpr static match_result match(Input input) {
+    return recognize(parse(input));
+  }
+
+private:
+  constexpr static char description[] = {Begin, '-', End};
+  constexpr static std::string_view expected = std::string_view(description, 3);
 };
 
 template <typename StringProvider>
@@ -127,12 +319,21 @@ struct parser<word<StringProvider>> {
       return succeed(string, {input.loc(), string.length()});
     }
 
-    return fail("Expected word.", input.loc());
+    return fail_expecting(input, "Expected word.", string);
+  }
+
+  template <typename Input>
+  constexpr static match_result match(Input input) {
+    return recognize(parse(input));
   }
 
 private:
   template <typename Input>
   constexpr static bool starts_with(Input input, std::string_view string) {
+    if constexpr (has_remaining_v<Input>) {
+      return input.remaining().starts_with(string);
+    }
+
     for (auto character : string) {
       if (input.ended() || input.peek() != character) {
         return false;
@@ -145,50 +346,302 @@ private:
   }
 };
 
-template <typename Rule>
-struct parser<sequence<Rule>> {
-  using result_type = result<std::tuple<result_value_t<parser_result_t<Rule>>>>;
+template <typename... StringProviders>
+struct parser<keywords<StringProviders...>> {
+  using result_type = result<std::string_view>;
 
   template <typename Input>
   constexpr static result_type parse(Input input) {
-    using tuple_type = result_value_t<result_type>;
+    std::size_t lower = 0;
+    std::size_t upper = sorted.size();
+    std::size_t length = 0;
 
-    auto result = parser<Rule>::parse(input);
+    auto longest = sorted.size();
 
-    if (result.is_failure()) {
-      return result.failure();
+    for (auto cursor = input; lower < upper; cursor = cursor.advanced_by(1), ++length) {
+      // Keywords sharing the current prefix are sorted, so those ending here come first.
+      while (lower < upper && sorted[lower].length() == length) {
+        longest = lower++;
+      }
+
+      if (lower == upper || cursor.ended()) {
+        break;
+      }
+
+      auto symbol = static_cast<unsigned char>(cursor.peek());
+      auto symbol_at = [length](std::string_view keyword) {
+        return static_cast<unsigned char>(keyword[length]);
+      };
+
+      auto first = sorted.begin() + lower;
+      auto last = sorted.begin() + upper;
+
+      first = std::partition_point(first, last, [&](auto k) { return symbol_at(k) < symbol; });
+      last = std::partition_point(first, last, [&](auto k) { return symbol_at(k) == symbol; });
+
+      lower = first - sorted.begin();
+      upper = last - sorted.begin();
+    }
+
+    if (longest == sorted.size()) {
+      if constexpr (records_expectations_v<Input>) {
+        (input.context().expected().record(input.loc(), StringProviders::string), ...);
+      }
+
+      return fail("Expected keyword.", input.loc());
     }
 
-    return succeed(tuple_type(result->get()), result->span());
+    return succeed(std::string_view(sorted[longest]), {input.loc(), sorted[longest].length()});
+  }
+
+  template <typename Input>
+  constexpr static match_result match(Input input) {
+    return recognize(parse(input));
+  }
+
+private:
+  constexpr static std::array<std::string_view, sizeof...(StringProviders)> sort() {
+    std::array<std::string_view, sizeof...(StringProviders)> strings = {
+        StringProviders::string...};
+    std::sort(strings.begin(), strings.end());
+    return strings;
   }
+
+  constexpr static std::array<std::string_view, sizeof...(StringProviders)> sorted = sort();
 };
 
-template <typename Rule, typename FollowingRule, typename... FollowingRules>
-struct parser<sequence<Rule, FollowingRule, FollowingRules...>> {
-  using result_type = result<std::tuple<result_value_t<parser_result_t<Rule>>,
-                                        result_value_t<parser_result_t<FollowingRule>>,
-                                        result_value_t<parser_result_t<FollowingRules>>...>>;
+template <typename Rule, typename... FollowingRules>
+struct parser<sequence<Rule, FollowingRules...>> {
+  /// Values of silent rules are left out of the tuple.
+  using result_type = result<decltype(std::tuple_cat(
+      std::declval<std::conditional_t<is_silent_v<Rule>, std::tuple<>,
+                                      std::tuple<result_value_t<parser_result_t<Rule>>>>>(),
+      std::declval<std::conditional_t<
+          is_silent_v<FollowingRules>, std::tuple<>,
+          std::tuple<result_value_t<parser_result_t<FollowingRules>>>>>()...))>;
 
   template <typename Input>
   constexpr static result_type parse(Input input) {
-    auto result = parser<sequence<Rule>>::parse(input);
+    return parse_all(std::move(input), std::make_index_sequence<rule_count>());
+  }
+
+  template <typename Input>
+  constexpr static match_result match(Input input) {
+    return match_all(std::move(input), std::make_index_sequence<rule_count>());
+  }
+
+private:
+  constexpr static std::size_t rule_count = 1 + sizeof...(FollowingRules);
+
+  using tuple_type = result_value_t<result_type>;
+
+  /// Storage of the value of a rule until all rules succeed. Silent rules store nothing.
+  struct no_value {};
+
+  template <typename SequencedRule>
+  using slot_t = std::conditional_t<is_silent_v<SequencedRule>, no_value,
+                                    std::optional<result_value_t<parser_result_t<SequencedRule>>>>;
+
+  using slots_type = std::tuple<slot_t<Rule>, slot_t<FollowingRules>...>;
+
+  /// Indices of the rules whose values make up the tuple.
+  constexpr static auto value_indices = [] {
+    constexpr std::array<bool, rule_count> silent = {is_silent_v<Rule>,
+                                                     is_silent_v<FollowingRules>...};
+
+    std::array<std::size_t, std::tuple_size_v<tuple_type>> indices = {};
+
+    for (std::size_t index = 0, value = 0; index < rule_count; ++index) {
+      if (!silent[index]) {
+        indices[value++] = index;
+      }
+    }
+
+    return indices;
+  }();
+
+  /// Index of the first commit marker, or the rule count if there is none.
+  constexpr static std::size_t commit_index = [] {
+    constexpr std::array<bool, rule_count> commits = {std::is_same_v<Rule, commit>,
+                                                      std::is_same_v<FollowingRules, commit>...};
+
+    return std::size_t(std::find(commits.begin(), commits.end(), true) - commits.begin());
+  }();
+
+  /// Failures after the commit marker are final.
+  template <std::size_t Index>
+  constexpr static failure_t failure_at(failure_t failure) {
+    if constexpr (Index > commit_index) {
+      return failure.commit();
+    } else {
+      return failure;
+    }
+  }
+
+  /// Parses the rules one after another into the slots, constructing the tuple from them once all
+  /// rules succeed. The input moves into each rule and gets advanced to its end afterwards, so
+  /// that only the rule being parsed holds inputs, like pins of stream chunks.
+  template <typename Input, std::size_t... Indices>
+  constexpr static result_type parse_all(Input input, std::index_sequence<Indices...>) {
+    auto begin = input.loc();
+
+    slots_type slots;
+    failure_t failure = fail("", begin);
+
+    if (!(parse_next<Indices>(input, slots, failure) && ...)) {
+      return failure;
+    }
+
+    return succeed(take_values(slots, std::make_index_sequence<value_indices.size()>()),
+                   {begin, input.loc()});
+  }
+
+  template <std::size_t Index, typename Input>
+  constexpr static bool parse_next(Input &input, slots_type &slots, failure_t &failure) {
+    using next_rule = at_index_t<Index, Rule, FollowingRules...>;
+
+    auto result = parser<next_rule>::parse(std::move(input));
 
     if (result.is_failure()) {
-      return result.failure();
+      failure = failure_at<Index>(at_furthest_expectation(input, result.failure()));
+      return false;
     }
 
-    auto following_result =
-        parser<sequence<FollowingRule, FollowingRules...>>::parse(input.advanced_to(result->end()));
+    if constexpr (!is_silent_v<next_rule>) {
+      std::get<Index>(slots).emplace(result->get());
+    }
+
+    input = input.advanced_to(result->end());
+    return true;
+  }
+
+  template <std::size_t... Values>
+  constexpr static tuple_type take_values(slots_type &slots, std::index_sequence<Values...>) {
+    return tuple_type(std::move(*std::get<value_indices[Values]>(slots))...);
+  }
 
-    if (following_result.is_failure()) {
-      return following_result.failure();
+  template <typename Input, std::size_t... Indices>
+  constexpr static match_result match_all(Input input, std::index_sequence<Indices...>) {
+    auto begin = input.loc();
+
+    match_result result = succeed(recognized{}, {begin, begin});
+
+    if (!(match_next<Indices>(input, result) && ...)) {
+      return result;
+    }
+
+    return succeed(recognized{}, {begin, result->end()});
+  }
+
+  template <std::size_t Index, typename Input>
+  constexpr static bool match_next(Input &input, match_result &result) {
+    result = parser<at_index_t<Index, Rule, FollowingRules...>>::match(std::move(input));
+
+    if (result.is_failure()) {
+      result = failure_at<Index>(at_furthest_expectation(input, result.failure()));
+      return false;
     }
 
-    auto value = std::tuple_cat(result->get(), following_result->get());
-    return succeed(std::move(value), {result->begin(), following_result->end()});
+    input = input.advanced_to(result->end());
+    return true;
   }
 };
 
+/// Recognizes the first of the alternative rules that matches the input, or returns the furthest
+/// failure among them. A committed failure is returned right away.
+template <typename... Rules, typename Input, std::size_t... Indices>
+constexpr match_result match_first(Input input, std::string_view message,
+                                   std::index_sequence<Indices...>) {
+  constexpr bool may_commit = (may_commit_v<Rules> || ...);
+
+  auto viable = choice_dispatch<Rules...>::viable(input);
+  auto is_viable = [viable](std::size_t index) { return index >= 64 || (viable >> index & 1); };
+
+  match_result result = fail(message, input.loc());
+  failure_t failure = result.failure();
+
+  auto attempt = [&](auto &&matched) {
+    result = matched;
+
+    if (result.is_failure() && !(may_commit && result.committed())) {
+      failure = furthest(failure, result.failure());
+      return false;
+    }
+
+    return true;
+  };
+
+  if ((... || (is_viable(Indices) && attempt(parser<Rules>::match(input))))) {
+    return result;
+  }
+
+  // The alternatives skipped by the dispatch fail on their first character, recording what they
+  // expected there as trying them in order would.
+  if constexpr (records_expectations_v<Input>) {
+    (..., (is_viable(Indices) || parser<Rules>::match(input).is_failure()));
+  }
+
+  return failure;
+}
+
+template <typename... Rules, typename Input>
+constexpr match_result match_first(Input input, std::string_view message) {
+  return match_first<Rules...>(input, message, std::index_sequence_for<Rules...>());
+}
+
+/// Parses the alternatives that cannot start on the input, only for the expectations they record
+/// when failing on its first character, as trying them in order would.
+template <typename Result, typename Input, std::size_t Count>
+constexpr void record_skipped(const Input &input, std::uint64_t viable,
+                              const std::array<Result (*)(Input), Count> &alternatives) {
+  if constexpr (records_expectations_v<Input>) {
+    for (std::size_t index = 0; index < Count && index < 64; ++index) {
+      if ((viable >> index & 1) == 0) {
+        alternatives[index](input);
+      }
+    }
+  }
+}
+
+/// Parses the alternatives viable on the input in order, returning the first success or the
+/// furthest failure. A committed failure is returned right away. Alternatives that cannot start on
+/// the input are only parsed once all others failed, for the expectations they record.
+template <typename Dispatch, bool MayCommit, typename Result, typename Input, std::size_t Count>
+constexpr Result parse_first(Input input, std::string_view message,
+                             const std::array<Result (*)(Input), Count> &alternatives) {
+  auto viable = Dispatch::viable(input);
+  auto failure = fail(message, input.loc());
+
+  // The only viable alternative is parsed without going through the others.
+  if (auto index = Dispatch::single(viable); index < Count) {
+    auto result = alternatives[index](input);
+
+    if (result.is_success() || (MayCommit && result.committed())) {
+      return result;
+    }
+
+    record_skipped(input, viable, alternatives);
+    return furthest(failure, result.failure());
+  }
+
+  for (std::size_t index = 0; index < Count; ++index) {
+    if (index < 64 && (viable >> index & 1) == 0) {
+      continue;
+    }
+
+    auto result = alternatives[index](input);
+
+    if (result.is_success() || (MayCommit && result.committed())) {
+      return result;
+    }
+
+    failure = furthest(failure, result.failure());
+  }
+
+  record_skipped(input, viable, alternatives);
+  return failure;
+}
+
 template <typename Rule>
 struct parser<either<Rule>> : parser<Rule> {};
 
@@ -198,19 +651,33 @@ struct parser<either<Rule, AlternativeRule, AlternativeRules...>> {
 
   template <typename Input>
   constexpr static result_type parse(Input input) {
-    auto result = parser<Rule>::parse(input);
+    using dispatch = choice_dispatch<Rule, AlternativeRule, AlternativeRules...>;
 
-    if (result.is_success()) {
-      return result;
-    }
+    constexpr auto alternatives = alternative_table<Input>(std::make_index_sequence<count>());
 
-    auto alternative_result = parser<either<AlternativeRule, AlternativeRules...>>::parse(input);
+    return parse_first<dispatch, may_commit>(input, "Parser.", alternatives);
+  }
 
-    if (alternative_result.is_success()) {
-      return alternative_result;
-    }
+  template <typename Input>
+  constexpr static match_result match(Input input) {
+    return match_first<Rule, AlternativeRule, AlternativeRules...>(input, "Parser.");
+  }
+
+private:
+  constexpr static std::size_t count = 2 + sizeof...(AlternativeRules);
+
+  constexpr static bool may_commit = may_commit_v<Rule> || may_commit_v<AlternativeRule> ||
+                                     (may_commit_v<AlternativeRules> || ...);
+
+  template <std::size_t Index, typename Input>
+  constexpr static result_type parse_alternative(Input input) {
+    return parser<at_index_t<Index, Rule, AlternativeRule, AlternativeRules...>>::parse(input);
+  }
 
-    return fail("Parser.", input.loc());
+  template <typename Input, std::size_t... Indices>
+  constexpr static std::array<result_type (*)(Input), count>
+  alternative_table(std::index_sequence<Indices...>) {
+    return {&parse_alternative<Indices, Input>...};
   }
 };
 
@@ -230,6 +697,11 @@ struct parser<one_of<Rule>> {
 
     return success_t(variant_type(result->get()), result->span());
   }
+
+  template <typename Input>
+  constexpr static match_result match(Input input) {
+    return parser<Rule>::match(input);
+  }
 };
 
 template <typename Rule, typename AlternativeRule, typename... AlternativeRules>
@@ -240,25 +712,43 @@ struct parser<one_of<Rule, AlternativeRule, AlternativeRules...>> {
 
   template <typename Input>
   constexpr static result_type parse(Input input) {
-    using variant_type = result_value_t<result_type>;
+    using dispatch = choice_dispatch<Rule, AlternativeRule, AlternativeRules...>;
 
-    auto cast_variant = [](auto small_variant) {
-      return percy::visit([](auto item) { return variant_type(item); }, small_variant);
-    };
+    constexpr auto alternatives = alternative_table<Input>(std::make_index_sequence<count>());
 
-    auto result = parser<one_of<Rule>>::parse(input);
+    return parse_first<dispatch, may_commit>(input, "One of failed.", alternatives);
+  }
 
-    if (result.is_success()) {
-      return succeed(cast_variant(result->get()), result->span());
-    }
+  template <typename Input>
+  constexpr static match_result match(Input input) {
+    return match_first<Rule, AlternativeRule, AlternativeRules...>(input, "One of failed.");
+  }
 
-    auto alternative_result = parser<one_of<AlternativeRule, AlternativeRules...>>::parse(input);
+private:
+  constexpr static std::size_t count = 2 + sizeof...(AlternativeRules);
+
+  constexpr static bool may_commit = may_commit_v<Rule> || may_commit_v<AlternativeRule> ||
+                                     (may_commit_v<AlternativeRules> || ...);
 
-    if (alternative_result.is_success()) {
-      return succeed(cast_variant(alternative_result->get()), alternative_result->span());
+  /// Parses a single alternative, constructing its value right in the resulting variant.
+  template <std::size_t Index, typename Input>
+  constexpr static result_type parse_alternative(Input input) {
+    using variant_type = result_value_t<result_type>;
+    using alternative = at_index_t<Index, Rule, AlternativeRule, AlternativeRules...>;
+
+    auto result = parser<alternative>::parse(input);
+
+    if (result.is_failure()) {
+      return result.failure();
     }
 
-    return fail("One of failed.", input.loc());
+    return succeed(variant_type(result->get()), result->span());
+  }
+
+  template <typename Input, std::size_t... Indices>
+  constexpr static std::array<result_type (*)(Input), count>
+  alternative_table(std::index_sequence<Indices...>) {
+    return {&parse_alternative<Indices, Input>...};
   }
 };
 
@@ -270,16 +760,355 @@ struct parser<many<Rule>> {
   constexpr static result_type parse(Input input) {
     using vector_type = result_value_t<result_type>;
 
-    auto start = input;
+    auto begin = input.loc();
+
+    if constexpr (is_char_class_v<Rule> && has_remaining_v<Input>) {
+      auto run = input.remaining();
+      auto length = scan<Rule>(run);
+      record_stop(input, length);
+      return succeed(vector_type(run.begin(), run.begin() + length), {begin, length});
+    }
 
     vector_type values;
 
-    while (auto result = parser<Rule>::parse(input)) {
+    while (true) {
+      auto result = parser<Rule>::parse(input);
+
+      if (result.is_failure()) {
+        if (is_committed<Rule>(result)) {
+          return result.failure();
+        }
+
+        break;
+      }
+
       values.push_back(result->get());
       input = input.advanced_to(result->end());
     }
 
-    return succeed(values, {start.loc(), input.loc()});
+    return succeed(std::move(values), {begin, input.loc()});
+  }
+
+  template <typename Input>
+  constexpr static match_result match(Input input) {
+    auto begin = input.loc();
+
+    if constexpr (is_char_class_v<Rule> && has_remaining_v<Input>) {
+      auto length = scan<Rule>(input.remaining());
+      record_stop(input, length);
+      return succeed(recognized{}, {begin, length});
+    }
+
+    while (true) {
+      auto result = parser<Rule>::match(input);
+
+      if (result.is_failure()) {
+        if (is_committed<Rule>(result)) {
+          return result.failure();
+        }
+
+        break;
+      }
+
+      input = input.advanced_to(result->end());
+    }
+
+    return succeed(recognized{}, {begin, input.loc()});
+  }
+
+private:
+  /// Records what the character class expected where its scanned run stopped, as the failure
+  /// ending the repetition would.
+  template <typename Input>
+  constexpr static void record_stop(const Input &input, std::size_t length) {
+    if constexpr (records_expectations_v<Input>) {
+      parser<Rule>::match(input.advanced_by(length));
+    }
+  }
+};
+
+template <typename Rule, typename Init, typename Step>
+struct parser<fold_many<Rule, Init, Step>> {
+  using result_type = result<std::decay_t<decltype(Init{}())>>;
+
+  template <typename Input>
+  constexpr static result_type parse(Input input) {
+    auto begin = input.loc();
+
+    auto accumulator = Init{}();
+
+    while (true) {
+      auto result = parser<Rule>::parse(input);
+
+      if (result.is_failure()) {
+        if (is_committed<Rule>(result)) {
+          return result.failure();
+        }
+
+        break;
+      }
+
+      accumulator = Step{}(std::move(accumulator), result->get());
+      input = input.advanced_to(result->end());
+    }
+
+    return succeed(std::move(accumulator), {begin, input.loc()});
+  }
+
+  template <typename Input>
+  constexpr static match_result match(Input input) {
+    return parser<many<Rule>>::match(input);
+  }
+};
+
+template <typename Rule>
+struct parser<and_<Rule>> {
+  using result_type = match_result;
+
+  template <typename Input>
+  constexpr static result_type parse(Input input) {
+    return match(input);
+  }
+
+  template <typename Input>
+  constexpr static match_result match(Input input) {
+    auto result = parser<Rule>::match(input);
+
+    if (result.is_failure()) {
+      return result;
+    }
+
+    return succeed(recognized{}, {input.loc(), input.loc()});
+  }
+};
+
+template <typename Rule>
+struct parser<not_<Rule>> {
+  using result_type = match_result;
+
+  template <typename Input>
+  constexpr static result_type parse(Input input) {
+    return match(input);
+  }
+
+  template <typename Input>
+  constexpr static match_result match(Input input) {
+    if (parser<Rule>::match(input).is_success()) {
+      return fail("Unexpected.", input.loc());
+    }
+
+    return succeed(recognized{}, {input.loc(), input.loc()});
+  }
+};
+
+template <typename Operand, typename... Levels>
+struct parser<operators<Operand, Levels...>> {
+  using result_type = match_result;
+  using operand_rule = Operand;
+
+  template <typename Input>
+  constexpr static result_type parse(Input input) {
+    return match(input);
+  }
+
+  template <typename Input>
+  constexpr static match_result match(Input input) {
+    auto operand = [](Input input) { return parser<Operand>::match(input); };
+    auto combine = [](recognized, char, recognized) { return recognized{}; };
+
+    return climb<recognized>(input, operand, combine);
+  }
+
+  /// Parses an operand by ParseOperand, followed by operators binding at least as tight as the
+  /// given precedence, each with its right operand. Each two operands get combined around their
+  /// operator by Combine. An operator without its right operand is left unparsed.
+  template <typename Node, typename Input, typename ParseOperand, typename Combine>
+  constexpr static result<Node> climb(Input input, const ParseOperand &parse_operand,
+                                      const Combine &combine, std::size_t min_precedence = 1) {
+    auto begin = input.loc();
+    auto operand = parse_operand(std::move(input));
+
+    if (operand.is_failure()) {
+      return operand.failure();
+    }
+
+    auto end = operand->end();
+    Node node = operand->get();
+
+    for (auto next = input.advanced_to(end); !next.ended(); next = next.advanced_to(end)) {
+      auto symbol = next.peek();
+      auto index = static_cast<unsigned char>(symbol);
+      auto precedence = table.precedences[index];
+
+      if (precedence < min_precedence) {
+        break;
+      }
+
+      auto next_precedence = table.right[index] ? precedence : precedence + 1;
+      auto rhs = climb<Node>(next.advanced_by(1), parse_operand, combine, next_precedence);
+
+      if (rhs.is_failure()) {
+        if (is_committed<Operand>(rhs)) {
+          return rhs.failure();
+        }
+
+        break;
+      }
+
+      end = rhs->end();
+      node = combine(std::move(node), symbol, rhs->get());
+    }
+
+    return succeed(std::move(node), {begin, end});
+  }
+
+private:
+  /// Precedences and associativities of the operator characters. Other characters have precedence
+  /// zero.
+  struct operator_table {
+    std::array<std::size_t, 256> precedences;
+    std::array<bool, 256> right;
+    std::size_t count;
+  };
+
+  template <typename Associativity, char Symbol, char... Symbols>
+  constexpr static void add_level(operator_table &table, std::size_t precedence,
+                                  level<Associativity, Symbol, Symbols...>) {
+    for (char symbol : {Symbol, Symbols...}) {
+      auto index = static_cast<unsigned char>(symbol);
+      table.count += table.precedences[index] == 0;
+      table.precedences[index] = precedence;
+      table.right[index] = std::is_same_v<Associativity, right>;
+    }
+  }
+
+  constexpr static operator_table build_table() {
+    operator_table table{};
+    std::size_t precedence = 0;
+    (add_level(table, ++precedence, Levels{}), ...);
+    return table;
+  }
+
+  template <typename Associativity, char Symbol, char... Symbols>
+  constexpr static std::size_t level_size(level<Associativity, Symbol, Symbols...>) {
+    return 1 + sizeof...(Symbols);
+  }
+
+  constexpr static operator_table table = build_table();
+
+  static_assert(table.count == (level_size(Levels{}) + ...),
+                "The `operators` rule requires each operator to occur only once.");
+};
+
+/// Memoized results are copied out of the table, so the value of Rule has to be copyable.
+///
+/// Results of parsing and of recognizing Rule are memoized apart, so recognizing it never runs its
+/// actions and never gets a value it would drop.
+///
+/// Left recursive invocations of Rule get its previous result, starting from a failure. Rule is
+/// parsed again as long as that gets further, growing the result. Left recursion is supported only
+/// on inputs with a context, and only through memoized invocations.
+template <typename Rule>
+struct parser<memo<Rule>> {
+  using result_type = parser_result_t<Rule>;
+
+  template <typename Input>
+  constexpr static result_type parse(Input input) {
+    if constexpr (has_context_v<Input>) {
+      return memoized<Rule>(input, [](Input input) { return parser<Rule>::parse(input); });
+    } else {
+      return parser<Rule>::parse(input);
+    }
+  }
+
+  template <typename Input>
+  constexpr static match_result match(Input input) {
+    if constexpr (has_context_v<Input>) {
+      return memoized<match_key>(input, [](Input input) { return parser<Rule>::match(input); });
+    } else {
+      return parser<Rule>::match(input);
+    }
+  }
+
+private:
+  /// Key of the memoized results of recognizing Rule.
+  struct match_key {};
+
+  /// The result of Parse at the input, memoized under Key.
+  template <typename Key, typename Input, typename Parse>
+  constexpr static auto memoized(Input input, const Parse &parse) {
+    using memo_result = decltype(parse(input));
+
+    auto &table = input.context().memo();
+    std::size_t extent = 0;
+
+    if (auto memoized = table.template find<Key, memo_result>(input.loc(), &extent)) {
+      if constexpr (tracks_examined_v<Input>) {
+        input.examine(extent);
+      }
+
+      return *memoized;
+    }
+
+    table.template enter<Key>(input.loc(), memo_result(fail("Left recursion.", input.loc())));
+
+    if constexpr (tracks_examined_v<Input>) {
+      // The extent of the rule is tracked on its own and then merged into the enclosing one.
+      auto enclosing = input.examined();
+      input.set_examined(input.loc().get());
+      auto result = parse_growing(input, table, parse);
+      extent = input.examined();
+      input.set_examined(std::max(enclosing, extent));
+
+      return table.leave(std::move(result), extent);
+    } else {
+      return table.leave(parse_growing(input, table, parse));
+    }
+  }
+
+  template <typename Input, typename Parse>
+  constexpr static auto parse_growing(Input input, memo_table &table, const Parse &parse) {
+    auto result = parse(input);
+
+    if (!table.recursive()) {
+      return result;
+    }
+
+    while (result.is_success()) {
+      auto end = result->end();
+      table.grow(result);
+
+      auto grown = parse(input);
+
+      if (grown.is_failure() || grown->end().get() <= end.get()) {
+        break;
+      }
+
+      result = std::move(grown);
+    }
+
+    return result;
+  }
+};
+
+template <typename Rule>
+struct parser<capture<Rule>> {
+  using result_type = result<std::string_view>;
+
+  template <typename Input>
+  constexpr static result_type parse(Input input) {
+    auto result = parser<Rule>::match(input);
+
+    if (result.is_failure()) {
+      return result.failure();
+    }
+
+    return succeed(input.slice(result->span()), result->span());
+  }
+
+  template <typename Input>
+  constexpr static match_result match(Input input) {
+    return parser<Rule>::match(input);
   }
 };
 } // namespace percy
@@ -0,0 +1,141 @@
+#ifndef PERCY_PROFILER
+#define PERCY_PROFILER
+
+#include "percy/context.hpp"
+#include "percy/memo_table.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <ostream>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace percy {
+/// The name of the type T as spelled by the compiler.
+template <typename T>
+constexpr std::string_view type_name() {
+#if defined(_MSC_VER) && !defined(__clang__)
+  std::string_view signature = __FUNCSIG__;
+  auto begin = signature.find("type_name<") + 10;
+  auto end = signature.rfind(">(void)");
+#else
+  std::string_view signature = __PRETTY_FUNCTION__;
+  auto begin = signature.find("T = ") + 4;
+  auto end = signature.find("; std::string_view", begin);
+
+  if (end == std::string_view::npos) {
+    end = signature.rfind(']');
+  }
+#endif
+
+  return signature.substr(begin, end - begin);
+}
+
+/// Statistics of the invocations of a custom rule.
+struct rule_profile {
+  std::string_view name;
+  std::size_t invocations = 0;
+  std::size_t successes = 0;
+  std::size_t failures = 0;
+  std::size_t consumed = 0;
+
+  /// Time spent in the rule, including the rules it invoked.
+  std::chrono::nanoseconds time = std::chrono::nanoseconds(0);
+};
+
+/// Statistics of the custom rules parsed in a profiling context.
+///
+/// The time of a rule includes the time of the rules it invoked, and the time of a recursive rule
+/// counts once for each level of the recursion.
+class profiler {
+public:
+  using clock = std::chrono::steady_clock;
+
+private:
+  std::unordered_map<const void *, rule_profile> profiles_;
+
+public:
+  profiler() : profiles_() {}
+
+  clock::time_point start() const { return clock::now(); }
+
+  /// Records an invocation of Rule started at the time point, consuming some characters on success.
+  template <typename Rule>
+  void record(clock::time_point start, bool success, std::size_t consumed) {
+    auto elapsed = clock::now() - start;
+    auto &profile = profiles_[&rule_key<Rule>::value];
+
+    profile.name = type_name<Rule>();
+    profile.invocations += 1;
+    profile.successes += success;
+    profile.failures += !success;
+    profile.consumed += consumed;
+    profile.time += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed);
+  }
+
+  /// Adds the statistics recorded by the other profiler, such as one of another worker.
+  void merge(const profiler &other) {
+    for (const auto &[rule, other_profile] : other.profiles_) {
+      auto &profile = profiles_[rule];
+
+      profile.name = other_profile.name;
+      profile.invocations += other_profile.invocations;
+      profile.successes += other_profile.successes;
+      profile.failures += other_profile.failures;
+      profile.consumed += other_profile.consumed;
+      profile.time += other_profile.time;
+    }
+  }
+
+  /// The statistics of the rules, the most time consuming first.
+  std::vector<rule_profile> profiles() const {
+    std::vector<rule_profile> profiles;
+
+    for (const auto &[rule, profile] : profiles_) {
+      profiles.push_back(profile);
+    }
+
+    std::sort(profiles.begin(), profiles.end(),
+              [](const auto &lhs, const auto &rhs) { return lhs.time > rhs.time; });
+
+    return profiles;
+  }
+
+  /// Writes a table of the statistics of the rules, the most time consuming first.
+  void report(std::ostream &out) const {
+    char line[160];
+
+    std::snprintf(line, sizeof(line), "%12s %12s %12s %14s %12s  %s\n", "invocations",
+                  "successes", "failures", "consumed", "time [us]", "rule");
+    out << line;
+
+    for (const auto &profile : profiles()) {
+      std::snprintf(line, sizeof(line), "%12zu %12zu %12zu %14zu %12.1f  ", profile.invocations,
+                    profile.successes, profile.failures, profile.consumed,
+                    profile.time.count() / 1000.0);
+      out << line << profile.name << '\n';
+    }
+  }
+
+  void clear() { profiles_.clear(); }
+};
+
+/// Parse context recording statistics of the custom rules parsed with it.
+///
+/// Profiling is selected at compile time by the type of the context. Parses with other contexts
+/// contain no profiling code at all.
+class profiling_context : public context {
+  percy::profiler profiler_;
+
+public:
+  profiling_context() : context(), profiler_() {}
+
+  percy::profiler &profiler() { return profiler_; }
+  const percy::profiler &profiler() const { return profiler_; }
+};
+} // namespace percy
+
+#endif
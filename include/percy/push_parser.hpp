@@ -0,0 +1,314 @@
+#ifndef PERCY_PUSH_PARSER
+#define PERCY_PUSH_PARSER
+
+#include "percy/incremental.hpp"
+#include "percy/input.hpp"
+#include "percy/parser.hpp"
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace percy {
+/// Rules parsed one after another into the tuple of their values, like the rules of a sequence.
+template <typename... Rules>
+struct rule_list {};
+
+/// How Rule splits around the repetition a push parser resumes across fragments: the rules before
+/// it, its item and the rules after it. Rules without such a repetition have a void item.
+///
+/// Repetitions are found in sequences and custom rules defined by them, so assemble builds the
+/// value of Rule from the values of the parts.
+template <typename Rule, typename Enabled = void>
+struct resumable_repetition {
+  using item = void;
+};
+
+template <typename Item>
+struct resumable_repetition<many<Item>> {
+  using prefix = rule_list<>;
+  using item = Item;
+  using suffix = rule_list<>;
+
+  template <typename Input, typename Context, typename Items>
+  constexpr static auto assemble(Context, input_span, std::tuple<>, Items items, std::tuple<>) {
+    return items;
+  }
+};
+
+namespace detail {
+template <typename Prefix, typename... Rules>
+struct split_at_repetition {
+  using item = void;
+};
+
+template <typename... Preceding, typename Item, typename... Following>
+struct split_at_repetition<rule_list<Preceding...>, many<Item>, Following...> {
+  using prefix = rule_list<Preceding...>;
+  using item = Item;
+  using suffix = rule_list<Following...>;
+
+  template <typename Input, typename Context, typename Values, typename Items,
+            typename FollowingValues>
+  constexpr static auto assemble(Context, input_span, Values prefix, Items items,
+                                 FollowingValues suffix) {
+    return std::tuple_cat(std::move(prefix), std::make_tuple(std::move(items)), std::move(suffix));
+  }
+};
+
+template <typename... Preceding, typename Rule, typename... Following>
+struct split_at_repetition<rule_list<Preceding...>, Rule, Following...>
+    : split_at_repetition<rule_list<Preceding..., Rule>, Following...> {};
+} // namespace detail
+
+template <typename Rule, typename... FollowingRules>
+struct resumable_repetition<sequence<Rule, FollowingRules...>>
+    : detail::split_at_repetition<rule_list<>, Rule, FollowingRules...> {};
+
+/// Custom rules apply their action to the value assembled for their rule, as their parsers do.
+template <typename Rule>
+struct resumable_repetition<Rule, std::enable_if_t<has_rule_v<Rule> &&
+                                                   !is_one_of_v<typename Rule::rule> &&
+                                                   !is_operators_v<typename Rule::rule>>>
+    : resumable_repetition<typename Rule::rule> {
+  using base = resumable_repetition<typename Rule::rule>;
+
+  template <typename Input, typename Context, typename... Parts>
+  constexpr static auto assemble(Context context, input_span span, Parts... parts) {
+    auto value = base::template assemble<Input>(context, span, std::move(parts)...);
+
+    if constexpr (is_sequence_v<typename Rule::rule>) {
+      auto action = [context](auto &&...values) {
+        return invoke_action<Rule, Input>(context, std::forward<decltype(values)>(values)...);
+      };
+
+      return std::apply(action, std::move(value));
+    } else {
+      auto raw_result = parser_result_t<typename Rule::rule>(succeed(std::move(value), span));
+      return invoke_action<Rule, Input>(context, std::move(raw_result));
+    }
+  }
+};
+
+template <typename Rule>
+using resumable_item_t = typename resumable_repetition<Rule>::item;
+
+namespace detail {
+/// Parser of the values of a list of rules, where the empty list succeeds with no values.
+template <typename Rules>
+struct rule_list_parser;
+
+template <>
+struct rule_list_parser<rule_list<>> {
+  constexpr static bool may_commit = false;
+
+  template <typename Input>
+  constexpr static result<std::tuple<>> parse(Input input) {
+    return succeed(std::tuple<>(), {input.loc(), input.loc()});
+  }
+};
+
+template <typename... Rules>
+struct rule_list_parser<rule_list<Rules...>> : parser<sequence<Rules...>> {
+  constexpr static bool may_commit = has_same_v<commit, Rules...>;
+};
+
+/// What a push parser keeps of a resumable repetition between fragments: the values of the rules
+/// before it, the values of its items and where the last of them ended.
+template <typename Rule, typename Item = resumable_item_t<Rule>>
+struct repetition_progress {
+  using repetition = resumable_repetition<Rule>;
+  using prefix_parser = rule_list_parser<typename repetition::prefix>;
+  using suffix_parser = rule_list_parser<typename repetition::suffix>;
+
+  std::optional<result_value_t<decltype(prefix_parser::parse(input("")))>> prefix;
+  std::vector<result_value_t<parser_result_t<Item>>> items;
+  std::size_t resumed = 0;
+};
+
+template <typename Rule>
+struct repetition_progress<Rule, void> {};
+} // namespace detail
+
+/// Parser of input arriving in fragments, completing Rule as soon as the fragments allow.
+///
+/// The parse completes once the result of Rule no longer depends on the end of the buffered input,
+/// so that no further input could change it. When Rule contains a repetition, in a sequence or a
+/// custom rule defined by one, the rules before the repetition are parsed once, and each fragment
+/// parses only the items it completed, keeping their values. The rules after the repetition are
+/// parsed from where it stopped, and the value of Rule is assembled from the kept values. Other
+/// rules get parsed again from their beginning on each fragment, which takes time quadratic in the
+/// number of fragments unless the rule completes within a few of them. Memoized rules the fragments
+/// could not have changed are reused by those parses, so memoizing the repeated units of such
+/// grammars is required to keep each parse cheap.
+///
+/// Values referring to the buffered input stay valid until the next fragment is fed. Kept values
+/// are parsed again when a fragment moves the buffer, which happens a logarithmic number of times.
+template <typename Rule, typename Context = incremental_context>
+class push_parser {
+public:
+  using result_type = parser_result_t<Rule>;
+
+private:
+  using item = resumable_item_t<Rule>;
+  using progress_type = detail::repetition_progress<Rule>;
+  using input_type = incremental_input<input, Context>;
+
+  std::string buffer_;
+  Context context_;
+  std::optional<result_type> result_;
+  progress_type progress_;
+
+public:
+  push_parser() : buffer_(), context_(), result_(), progress_() {}
+
+  /// Appends the fragment to the input. Returns whether Rule completed, possibly before the end of
+  /// the fragment. The rest of the input is kept for the next parse.
+  bool feed(std::string_view fragment) {
+    auto data = buffer_.data();
+
+    auto change = edit{buffer_.size(), 0, fragment};
+    change.apply(buffer_);
+    context_.apply(change);
+
+    // Kept values may refer to the buffered input.
+    if (buffer_.data() != data) {
+      progress_ = progress_type();
+    }
+
+    return complete() || resume(false);
+  }
+
+  /// Ends the input, completing Rule.
+  result_type &finish() {
+    if (!complete()) {
+      resume(true);
+    }
+
+    return *result_;
+  }
+
+  bool complete() const { return result_.has_value(); }
+
+  /// The result of the completed Rule.
+  result_type &result() { return *result_; }
+
+  /// Starts parsing the input following the completed Rule. Returns whether the next Rule
+  /// completed already.
+  bool next() {
+    auto consumed = result_->is_success() ? (*result_)->end().get() : buffer_.size();
+
+    auto change = edit{0, consumed, std::string_view()};
+    change.apply(buffer_);
+    context_.apply(change);
+
+    result_.reset();
+    progress_ = progress_type();
+    return resume(false);
+  }
+
+private:
+  input_type buffered() { return with_incremental_context(input(buffer_), context_); }
+
+  /// Whether the parse since examined was reset depended on the end of the buffered input.
+  bool needs_input(bool ended) const { return !ended && context_.examined() > buffer_.size(); }
+
+  /// Parses what the fragments allow, completing Rule unless it needs more input. Ended input
+  /// completes Rule in any case.
+  bool resume(bool ended) {
+    if constexpr (std::is_void_v<item>) {
+      context_.set_examined(0);
+
+      auto result = parser<Rule>::parse(buffered());
+
+      // Examining the end of the buffered input means more input could change the result.
+      if (needs_input(ended)) {
+        return false;
+      }
+
+      result_.emplace(std::move(result));
+      return true;
+    } else {
+      return resume_repetition(ended);
+    }
+  }
+
+  bool resume_repetition(bool ended) {
+    using repetition = resumable_repetition<Rule>;
+    using prefix_parser = typename progress_type::prefix_parser;
+    using suffix_parser = typename progress_type::suffix_parser;
+
+    // Failures after a commit marker before the repetition are final.
+    auto after_prefix = [](failure_t failure) {
+      return prefix_parser::may_commit ? failure.commit() : failure;
+    };
+
+    if (!progress_.prefix) {
+      context_.set_examined(0);
+
+      auto prefix = prefix_parser::parse(buffered());
+
+      if (needs_input(ended)) {
+        return false;
+      }
+
+      if (prefix.is_failure()) {
+        result_.emplace(prefix.failure());
+        return true;
+      }
+
+      progress_.resumed = prefix->end().get();
+      progress_.prefix.emplace(std::move(prefix->get()));
+    }
+
+    while (true) {
+      context_.set_examined(0);
+
+      auto parsed = parser<item>::parse(buffered().advanced_by(progress_.resumed));
+
+      if (needs_input(ended)) {
+        return false;
+      }
+
+      if (parsed.is_failure()) {
+        if (is_committed<item>(parsed)) {
+          result_.emplace(parsed.failure());
+          return true;
+        }
+
+        break;
+      }
+
+      progress_.items.push_back(std::move(parsed->get()));
+      progress_.resumed = parsed->end().get();
+    }
+
+    context_.set_examined(0);
+
+    auto suffix = suffix_parser::parse(buffered().advanced_by(progress_.resumed));
+
+    if (needs_input(ended)) {
+      return false;
+    }
+
+    if (suffix.is_failure()) {
+      result_.emplace(after_prefix(suffix.failure()));
+      return true;
+    }
+
+    auto span = input_span(input_location(0), suffix->end());
+    auto value = repetition::template assemble<input_type>(
+        &context_, span, std::move(*progress_.prefix), std::move(progress_.items),
+        std::move(suffix->get()));
+
+    result_.emplace(succeed(std::move(value), span));
+    return true;
+  }
+};
+} // namespace percy
+
+#endif
@@ -5,55 +5,129 @@
 
 #include <percy/variant.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
 namespace percy {
+/// Descriptions of the terminal rules expected at the furthest location a parse failed at. At most
+/// capacity distinct descriptions are kept.
+///
+/// Expectations are recorded out of line by the parse context, so that failures stay small.
+class expectations {
+public:
+  constexpr static std::size_t capacity = 8;
+
+  constexpr expectations() : descriptions_(), size_(0), location_(0) {}
+
+  /// Records the description expected at the location. Descriptions expected before the furthest
+  /// location recorded so far are ignored, those expected further replace them.
+  constexpr void record(input_location location, std::string_view description) {
+    if (location.get() < location_.get()) {
+      return;
+    }
+
+    if (location.get() > location_.get()) {
+      location_ = location;
+      size_ = 0;
+    }
+
+    insert(description);
+  }
+
+  constexpr void insert(std::string_view description) {
+    if (size_ < capacity && !contains(description)) {
+      descriptions_[size_++] = description;
+    }
+  }
+
+  constexpr bool contains(std::string_view description) const {
+    return std::find(begin(), end(), description) != end();
+  }
+
+  /// The furthest location a description was recorded at.
+  constexpr input_location loc() const { return location_; }
+
+  constexpr std::size_t size() const { return size_; }
+  constexpr bool empty() const { return size_ == 0; }
+
+  constexpr const std::string_view *begin() const { return descriptions_.data(); }
+  constexpr const std::string_view *end() const { return descriptions_.data() + size_; }
+
+  constexpr void clear() {
+    size_ = 0;
+    location_ = input_location(0);
+  }
+
+private:
+  std::array<std::string_view, capacity> descriptions_;
+  std::size_t size_;
+  input_location location_;
+};
+
 class failure_t {
+  /// The committed flag takes the highest bit of the location, keeping failures as small as a
+  /// message and a location.
+  constexpr static std::size_t committed_bit = std::size_t(1) << (sizeof(std::size_t) * 8 - 1);
+
   std::string_view message_;
-  input_location location_;
+  std::size_t location_;
 
 public:
   constexpr failure_t(std::string_view message, input_location location)
-      : message_(message), location_(location) {}
+      : message_(message), location_(location.get()) {}
 
-  constexpr input_location loc() const { return location_; }
+  constexpr std::string_view message() const { return message_; }
+  constexpr input_location loc() const { return input_location(location_ & ~committed_bit); }
+
+  /// Whether the failure is final, so that no alternative gets tried instead.
+  constexpr bool committed() const { return (location_ & committed_bit) != 0; }
+
+  /// The same failure made final.
+  constexpr failure_t commit() const {
+    auto failure = *this;
+    failure.location_ |= committed_bit;
+    return failure;
+  }
 };
 
 constexpr failure_t fail(std::string_view message, input_location location) {
   return failure_t(message, location);
 }
 
+/// The failure that got further into the input. Equally far failures keep the first one.
+constexpr failure_t furthest(const failure_t &failure, const failure_t &other) {
+  return other.loc().get() > failure.loc().get() ? other : failure;
+}
+
 template <typename Node>
 class success_t {
-  struct empty {};
-
-  percy::variant<Node, empty> node_;
+  Node node_;
   input_span span_;
 
 public:
   using value_type = Node;
 
-  constexpr success_t(Node &&node, input_span span)
-      : node_(std::forward<Node>(node)), span_(span) {}
+  constexpr success_t(Node &&node, input_span span) : node_(std::move(node)), span_(span) {}
+  constexpr success_t(const Node &node, input_span span) : node_(node), span_(span) {}
 
-  constexpr Node get() {
-    Node node = percy::get<Node>(node_);
-    node_ = empty{};
-    return std::move(node);
-  }
+  /// Moves the node out of the success, leaving it moved-from. Returning the moved node directly
+  /// takes a single move, which does not depend on the compiler eliding the copy of a local.
+  constexpr Node get() { return std::move(node_); }
 
-  constexpr Node get() const {
-    return percy::get<Node>(node_);
-  }
+  constexpr Node get() const { return node_; }
 
   constexpr input_span span() const { return span_; }
   constexpr input_location begin() const { return span_.begin(); }
   constexpr input_location end() const { return span_.end(); }
-
-  constexpr ~success_t() = default;
 };
 
 template <typename Node>
-constexpr success_t<Node> succeed(Node &&node, input_span span) {
-  return success_t<Node>(std::forward<Node>(node), span);
+constexpr success_t<std::remove_cvref_t<Node>> succeed(Node &&node, input_span span) {
+  return success_t<std::remove_cvref_t<Node>>(std::forward<Node>(node), span);
 }
 
 template <typename Node>
@@ -62,7 +136,7 @@ public:
   using success_type = success_t<Node>;
   using failure_type = failure_t;
 
-  constexpr result(success_type&& value) : value_(std::move(value)) {}
+  constexpr result(success_type &&value) : value_(std::move(value)) {}
   constexpr result(failure_type value) : value_(value) {}
 
   constexpr operator bool() const { return is_success(); }
@@ -73,11 +147,48 @@ public:
   constexpr success_type *operator->() { return &percy::get<success_type>(value_); }
   constexpr failure_t failure() const { return percy::get<failure_type>(value_); }
 
-  constexpr ~result() = default;
+  /// Whether the result is a committed failure, checked without copying the failure out.
+  constexpr bool committed() const {
+    return is_failure() && percy::get<failure_type>(value_).committed();
+  }
 
 private:
   percy::variant<success_type, failure_type> value_;
 };
+
+/// Moves the locations of the result after removed characters before it were replaced by inserted
+/// ones.
+template <typename Node>
+constexpr result<Node> shifted(result<Node> parsed, std::size_t removed, std::size_t inserted) {
+  auto shift = [=](input_location location) {
+    return input_location(location.get() - removed + inserted);
+  };
+
+  if (parsed.is_failure()) {
+    auto failure = parsed.failure();
+    auto moved = failure_t(failure.message(), shift(failure.loc()));
+    return failure.committed() ? moved.commit() : moved;
+  }
+
+  auto span = parsed->span();
+  return succeed(parsed->get(), {shift(span.begin()), shift(span.end())});
+}
+
+/// The value of a successful recognize-only parse.
+struct recognized {};
+
+/// The result of a recognize-only parse.
+using match_result = result<recognized>;
+
+/// Drops the value of the result, keeping only the outcome and the span.
+template <typename Node>
+constexpr match_result recognize(const result<Node> &parsed) {
+  if (parsed.is_failure()) {
+    return parsed.failure();
+  }
+
+  return succeed(recognized{}, parsed->span());
+}
 } // namespace percy
 
 #endif
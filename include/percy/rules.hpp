@@ -18,9 +18,17 @@ struct range {
 template <typename StringProvider>
 struct word {};
 
+template <typename StringProvider, typename... StringProviders>
+struct keywords {};
+
 template <typename Rule, typename... FollowingRules>
 struct sequence {};
 
+/// Marker in a sequence after which a failure of the sequence is final. Enclosing choices try no
+/// other alternatives and enclosing repetitions fail with it. Passing the marker also allows the
+/// parse context to release memoized results before it. The marker adds no value to the sequence.
+struct commit {};
+
 template <typename Rule, typename... AlternativeRules>
 struct either {
   static_assert(are_same_v<parser_result_t<Rule>, parser_result_t<AlternativeRules>...>,
@@ -35,6 +43,90 @@ struct one_of {
 
 template <typename Rule>
 struct many {};
+
+template <typename Rule, typename Init, typename Step>
+struct fold_many {};
+
+/// Repetition of Rule, parsing long inputs in chunks split right after Delimiter characters. The
+/// result is that of many<Rule> as long as occurrences examine no text past the ones following
+/// them. Chunks disagreeing with a sequential parse at their boundary, like ones split after a
+/// delimiter inside an occurrence, are parsed again sequentially, so splits work best where
+/// occurrences end. The parser is defined in percy/parallel_many.hpp.
+template <typename Rule, typename Delimiter>
+struct parallel_many {};
+
+template <typename Rule>
+struct memo {};
+
+template <typename Rule>
+struct capture {};
+
+/// Succeeds without consuming any input where Rule matches. Rule is only recognized, so its
+/// actions do not run. The predicate adds no value to a sequence.
+template <typename Rule>
+struct and_ {};
+
+/// Succeeds without consuming any input where Rule does not match. Rule is only recognized, so its
+/// actions do not run. The predicate adds no value to a sequence.
+template <typename Rule>
+struct not_ {};
+
+/// Operators of a precedence level grouping to the left.
+struct left {};
+
+/// Operators of a precedence level grouping to the right.
+struct right {};
+
+/// Binary operators sharing a precedence and an associativity.
+template <typename Associativity, char Operator, char... Operators>
+struct level {
+  static_assert(std::is_same_v<Associativity, left> || std::is_same_v<Associativity, right>,
+                "The `level` rule requires the associativity to be `left` or `right`.");
+};
+
+/// Operands joined by binary operators, parsed by precedence climbing. The levels go from the
+/// loosest binding operators to the tightest binding ones. As a custom rule, its action combines
+/// two operands around an operator, otherwise the operators are only recognized.
+template <typename Operand, typename Level, typename... Levels>
+struct operators {};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// Whether Rule contains a commit marker. Rules already being visited add nothing.
+template <typename Rule, typename Enabled = void, typename... Visited>
+struct may_commit {
+  constexpr static bool value = false;
+};
+
+template <typename... Visited>
+struct may_commit<commit, void, Visited...> {
+  constexpr static bool value = true;
+};
+
+template <typename Rule, typename... Visited>
+struct may_commit<Rule, std::enable_if_t<has_rule_v<Rule>>, Visited...> {
+  constexpr static bool compute() {
+    if constexpr (has_same_v<Rule, Visited...>) {
+      return false;
+    } else {
+      return may_commit<typename Rule::rule, void, Rule, Visited...>::value;
+    }
+  }
+
+  constexpr static bool value = compute();
+};
+
+/// Rules built from other rules contain the markers of their parts.
+template <template <typename...> typename Template, typename... Rules, typename... Visited>
+struct may_commit<Template<Rules...>, std::enable_if_t<!has_rule_v<Template<Rules...>>>,
+                  Visited...> {
+  constexpr static bool value = (may_commit<Rules, void, Visited...>::value || ...);
+};
+
+/// Determines whether parsing Rule can produce a committed failure. Grammars without commit markers
+/// skip checking for them altogether.
+template <typename Rule>
+constexpr inline bool may_commit_v = may_commit<Rule>::value;
 } // namespace percy
 
 #endif
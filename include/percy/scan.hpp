@@ -0,0 +1,144 @@
+#ifndef PERCY_SCAN
+#define PERCY_SCAN
+
+#include "percy/first_set.hpp"
+#include "percy/rules.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace percy {
+/// Rule matching exactly one character from a fixed set.
+template <typename Rule>
+struct char_class {
+  constexpr static bool value = false;
+};
+
+template <char Symbol>
+struct char_class<symbol<Symbol>> {
+  constexpr static bool value = true;
+
+#if defined(__SSE2__)
+  static __m128i match(__m128i chunk) { return _mm_cmpeq_epi8(chunk, _mm_set1_epi8(Symbol)); }
+#endif
+
+#if defined(__AVX2__)
+  static __m256i match(__m256i chunk) { return _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(Symbol)); }
+#endif
+};
+
+template <char Begin, char End>
+struct char_class<range<Begin, End>> {
+  constexpr static bool value = true;
+
+  // Characters in the range are exactly those whose wrapping distance from Begin does not exceed
+  // the width of the range, regardless of the signedness of char.
+
+#if defined(__SSE2__)
+  static __m128i match(__m128i chunk) {
+    auto distance = _mm_sub_epi8(chunk, _mm_set1_epi8(Begin));
+    auto width = _mm_set1_epi8(static_cast<char>(End - Begin));
+    return _mm_cmpeq_epi8(_mm_min_epu8(distance, width), distance);
+  }
+#endif
+
+#if defined(__AVX2__)
+  static __m256i match(__m256i chunk) {
+    auto distance = _mm256_sub_epi8(chunk, _mm256_set1_epi8(Begin));
+    auto width = _mm256_set1_epi8(static_cast<char>(End - Begin));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(distance, width), distance);
+  }
+#endif
+};
+
+template <typename Rule, typename... AlternativeRules>
+struct char_class<either<Rule, AlternativeRules...>> {
+  constexpr static bool value =
+      char_class<Rule>::value && (char_class<AlternativeRules>::value && ...);
+
+#if defined(__SSE2__)
+  static __m128i match(__m128i chunk) {
+    auto matched = char_class<Rule>::match(chunk);
+    ((matched = _mm_or_si128(matched, char_class<AlternativeRules>::match(chunk))), ...);
+    return matched;
+  }
+#endif
+
+#if defined(__AVX2__)
+  static __m256i match(__m256i chunk) {
+    auto matched = char_class<Rule>::match(chunk);
+    ((matched = _mm256_or_si256(matched, char_class<AlternativeRules>::match(chunk))), ...);
+    return matched;
+  }
+#endif
+};
+
+/// Determines whether Rule matches exactly one character from a fixed set.
+template <typename Rule>
+constexpr inline bool is_char_class_v = char_class<Rule>::value;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+template <typename Rule>
+inline std::size_t scan_vectorized(std::string_view text) {
+  std::size_t length = 0;
+
+#if defined(__AVX2__)
+  for (; length + 32 <= text.size(); length += 32) {
+    auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(text.data() + length));
+    auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(char_class<Rule>::match(chunk)));
+
+    if (mask != ~std::uint32_t(0)) {
+      return length + std::countr_one(mask);
+    }
+  }
+#endif
+
+#if defined(__SSE2__)
+  for (; length + 16 <= text.size(); length += 16) {
+    auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text.data() + length));
+    auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(char_class<Rule>::match(chunk)));
+
+    if (mask != 0xffff) {
+      return length + std::countr_one(mask);
+    }
+  }
+#endif
+
+  return length;
+}
+} // namespace detail
+
+/// The length of the longest prefix of text consisting of characters matched by Rule.
+template <typename Rule>
+constexpr std::size_t scan(std::string_view text) {
+  static_assert(is_char_class_v<Rule>, "Only character classes can be scanned.");
+
+  std::size_t length = 0;
+
+  if (!std::is_constant_evaluated()) {
+    length = detail::scan_vectorized<Rule>(text);
+  }
+
+  constexpr auto set = first_set_of_v<Rule>;
+
+  while (length < text.size() && set.admits(text[length])) {
+    ++length;
+  }
+
+  return length;
+}
+} // namespace percy
+
+#endif
@@ -0,0 +1,249 @@
+#ifndef PERCY_STREAM_INPUT
+#define PERCY_STREAM_INPUT
+
+#include "percy/input_span.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <string>
+#include <utility>
+
+#if __has_include(<unistd.h>)
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+namespace percy {
+class stream_input;
+
+/// Text pulled in chunks from a reader, shared by all inputs reading it.
+///
+/// Every live input pins the chunk it points into. Releasing an input discards the chunks at the
+/// front of the stream that no input pins and that end before its location, since no backtracking
+/// point can reach them anymore. The chunk of the released location stays, so that a parser that
+/// moved its input into a rule can still advance the moved-from input to where the rule ended.
+/// Parsers only keep inputs alive while they can still backtrack to them, so repetitions at the
+/// top of the grammar, alone or in sequences and custom rules, parse arbitrarily long streams in
+/// bounded memory.
+///
+/// Inputs alive when the parse commits belong to the enclosing rules, which cannot backtrack past
+/// the commit marker anymore. A commit therefore drops their pins, and only the committing input
+/// and the inputs created after it keep chunks, so committed repetitions nested in other rules
+/// parse in bounded memory too. Lookaheads must not contain commit markers on streams, since they
+/// go back before the commit after succeeding.
+class stream {
+public:
+  /// Fills the buffer with at most the given number of characters, returning how many it read.
+  /// Reading no characters ends the stream.
+  using reader_type = std::function<std::size_t(char *, std::size_t)>;
+
+  constexpr static std::size_t default_chunk_size = 64 * 1024;
+
+  explicit stream(reader_type reader, std::size_t chunk_size = default_chunk_size)
+      : reader_(std::move(reader)), chunk_size_(chunk_size), chunks_(), first_index_(0), end_(0),
+        generation_(0), exhausted_(false) {
+    assert(chunk_size_ > 0 && "The stream requires chunks to hold at least one character.");
+  }
+
+#if __has_include(<unistd.h>)
+  /// Stream reading the file descriptor until its end.
+  static stream from_descriptor(int descriptor, std::size_t chunk_size = default_chunk_size) {
+    auto reader = [descriptor](char *buffer, std::size_t size) -> std::size_t {
+      auto count = ::read(descriptor, buffer, size);
+
+      while (count < 0 && errno == EINTR) {
+        count = ::read(descriptor, buffer, size);
+      }
+
+      return count > 0 ? static_cast<std::size_t>(count) : 0;
+    };
+
+    return stream(reader, chunk_size);
+  }
+#endif
+
+  stream(const stream &) = delete;
+  stream &operator=(const stream &) = delete;
+
+  /// Input at the first character the stream still holds.
+  stream_input input();
+
+  /// The number of characters currently held by the stream.
+  std::size_t buffered() const { return chunks_.empty() ? 0 : end_ - chunks_.front().begin; }
+
+private:
+  friend class stream_input;
+
+  constexpr static std::size_t no_chunk = std::numeric_limits<std::size_t>::max();
+  constexpr static std::size_t no_generation = std::numeric_limits<std::size_t>::max();
+
+  struct chunk {
+    std::size_t begin;
+    std::string data;
+    std::size_t pins;
+  };
+
+  reader_type reader_;
+  std::size_t chunk_size_;
+  std::deque<chunk> chunks_;
+  std::size_t first_index_;
+  std::size_t end_;
+  std::size_t generation_;
+  bool exhausted_;
+
+  chunk &at(std::size_t index) { return chunks_[index - first_index_]; }
+
+  /// Index of the chunk containing the location, or no_chunk at the end of the stream.
+  std::size_t locate(std::size_t location, std::size_t hint) {
+    while (location >= end_) {
+      if (!load()) {
+        return no_chunk;
+      }
+    }
+
+    auto index = hint == no_chunk || hint < first_index_ ? first_index_ : hint;
+
+    assert(location >= chunks_.front().begin && "The location was already discarded.");
+
+    while (location < at(index).begin) {
+      --index;
+    }
+
+    while (location >= at(index).begin + at(index).data.size()) {
+      ++index;
+    }
+
+    return index;
+  }
+
+  bool load() {
+    if (exhausted_) {
+      return false;
+    }
+
+    std::string data(chunk_size_, '\0');
+    data.resize(reader_(data.data(), data.size()));
+
+    if (data.empty()) {
+      exhausted_ = true;
+      return false;
+    }
+
+    chunks_.push_back({end_, std::move(data), 0});
+    end_ += chunks_.back().data.size();
+    return true;
+  }
+
+  /// Pins the chunk, returning the generation of the pin, or no_generation if nothing got pinned.
+  /// Inputs of enclosing rules may point into chunks that commits already discarded.
+  std::size_t pin(std::size_t index) {
+    if (index == no_chunk || index < first_index_) {
+      return no_generation;
+    }
+
+    ++at(index).pins;
+    return generation_;
+  }
+
+  /// Pins dropped by a commit since the input pinned its chunk are not released again.
+  void unpin(std::size_t index, std::size_t generation, std::size_t location) {
+    if (generation == generation_) {
+      --at(index).pins;
+    }
+
+    discard(location);
+  }
+
+  /// Drops the pins of all inputs and pins the chunk of the committing input again.
+  std::size_t commit(std::size_t index, std::size_t location) {
+    for (auto &chunk : chunks_) {
+      chunk.pins = 0;
+    }
+
+    ++generation_;
+    discard(location);
+    return pin(index);
+  }
+
+  void discard(std::size_t location) {
+    while (!chunks_.empty() && chunks_.front().pins == 0 &&
+           chunks_.front().begin + chunks_.front().data.size() <= location) {
+      chunks_.pop_front();
+      ++first_index_;
+    }
+  }
+};
+
+/// Input reading a stream. A moved-from input keeps its location, so it can still be advanced.
+class stream_input {
+  stream *stream_;
+  std::size_t index_;
+  std::size_t location_;
+  const char *data_;
+  std::size_t chunk_begin_;
+  std::size_t generation_;
+
+public:
+  stream_input(stream &source, std::size_t location, std::size_t hint = stream::no_chunk)
+      : stream_(&source), index_(source.locate(location, hint)), location_(location),
+        data_(nullptr), chunk_begin_(0), generation_(stream::no_generation) {
+    if (index_ != stream::no_chunk) {
+      auto &chunk = stream_->at(index_);
+      data_ = chunk.data.data();
+      chunk_begin_ = chunk.begin;
+      generation_ = stream_->pin(index_);
+    }
+  }
+
+  stream_input(const stream_input &other)
+      : stream_(other.stream_), index_(other.index_), location_(other.location_),
+        data_(other.data_), chunk_begin_(other.chunk_begin_),
+        generation_(stream_->pin(index_)) {}
+
+  stream_input(stream_input &&other) noexcept
+      : stream_(other.stream_), index_(std::exchange(other.index_, stream::no_chunk)),
+        location_(other.location_), data_(other.data_), chunk_begin_(other.chunk_begin_),
+        generation_(std::exchange(other.generation_, stream::no_generation)) {}
+
+  stream_input &operator=(const stream_input &other) {
+    return *this = stream_input(other);
+  }
+
+  stream_input &operator=(stream_input &&other) noexcept {
+    std::swap(stream_, other.stream_);
+    std::swap(index_, other.index_);
+    std::swap(location_, other.location_);
+    std::swap(data_, other.data_);
+    std::swap(chunk_begin_, other.chunk_begin_);
+    std::swap(generation_, other.generation_);
+    return *this;
+  }
+
+  ~stream_input() { stream_->unpin(index_, generation_, location_); }
+
+  char peek() const { return index_ == stream::no_chunk ? '\0' : data_[location_ - chunk_begin_]; }
+  bool ended() const { return index_ == stream::no_chunk; }
+
+  input_location loc() const { return input_location(location_); }
+
+  /// Discards the chunks before the location, which the parse cannot backtrack to anymore.
+  void commit() { generation_ = stream_->commit(index_, location_); }
+
+  stream_input advanced_by(std::size_t offset) const {
+    return stream_input(*stream_, location_ + offset, index_);
+  }
+
+  stream_input advanced_to(input_location location) const {
+    return stream_input(*stream_, location.get(), index_);
+  }
+};
+
+inline stream_input stream::input() {
+  return stream_input(*this, chunks_.empty() ? end_ : chunks_.front().begin);
+}
+} // namespace percy
+
+#endif
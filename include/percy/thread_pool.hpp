@@ -0,0 +1,176 @@
+#ifndef PERCY_THREAD_POOL
+#define PERCY_THREAD_POOL
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace percy {
+/// Fixed set of threads running submitted tasks, each worker with its own queue.
+///
+/// Workers take the newest task of their own queue and steal the oldest tasks of the others when
+/// theirs runs dry. Tasks submitted from a worker go to its own queue, the others are spread
+/// evenly.
+class thread_pool {
+  struct queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  struct worker_state {
+    const thread_pool *pool = nullptr;
+    std::size_t index = 0;
+  };
+
+  std::vector<std::unique_ptr<queue>> queues_;
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable available_;
+  std::size_t queued_;
+  std::atomic<std::size_t> next_queue_;
+  bool stopping_;
+
+  static worker_state &current() {
+    thread_local worker_state state;
+    return state;
+  }
+
+public:
+  explicit thread_pool(std::size_t size = std::thread::hardware_concurrency())
+      : queues_(), workers_(), mutex_(), available_(), queued_(0), next_queue_(0),
+        stopping_(false) {
+    size = size == 0 ? 1 : size;
+
+    for (std::size_t i = 0; i < size; ++i) {
+      queues_.push_back(std::make_unique<queue>());
+    }
+
+    for (std::size_t i = 0; i < size; ++i) {
+      workers_.emplace_back([this, i] { work(i); });
+    }
+  }
+
+  thread_pool(const thread_pool &) = delete;
+  thread_pool &operator=(const thread_pool &) = delete;
+
+  /// Waits for the submitted tasks to finish.
+  ~thread_pool() {
+    {
+      std::lock_guard lock(mutex_);
+      stopping_ = true;
+    }
+
+    available_.notify_all();
+
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+  }
+
+  /// The pool shared by parsers, with a thread per hardware thread.
+  static thread_pool &shared() {
+    static thread_pool pool;
+    return pool;
+  }
+
+  /// Whether the calling thread is a worker of some pool. Tasks waiting for other tasks of the
+  /// same pool could exhaust it, so parsers run sequentially on workers.
+  static bool is_worker() { return current().pool != nullptr; }
+
+  /// Index of the calling thread among the workers of the pool, or the size of the pool if the
+  /// thread is not its worker.
+  std::size_t worker_index() const { return current().pool == this ? current().index : size(); }
+
+  // The queues are all created before the workers start, unlike the list of the workers.
+  std::size_t size() const { return queues_.size(); }
+
+  template <typename Function>
+  std::future<std::invoke_result_t<Function>> submit(Function function) {
+    using task_type = std::packaged_task<std::invoke_result_t<Function>()>;
+
+    auto task = std::make_shared<task_type>(std::move(function));
+    auto future = task->get_future();
+
+    push([task] { (*task)(); });
+    return future;
+  }
+
+private:
+  void push(std::function<void()> task) {
+    auto index = worker_index();
+
+    if (index == size()) {
+      index = next_queue_.fetch_add(1, std::memory_order_relaxed) % size();
+    }
+
+    // Counting the task in the same critical section keeps a worker that takes it from
+    // decrementing the count before it was incremented.
+    {
+      std::lock_guard count_lock(mutex_);
+      std::lock_guard queue_lock(queues_[index]->mutex);
+      queues_[index]->tasks.push_back(std::move(task));
+      ++queued_;
+    }
+
+    available_.notify_one();
+  }
+
+  bool pop(std::size_t index, std::function<void()> &task) {
+    for (std::size_t offset = 0; offset < size(); ++offset) {
+      auto &victim = *queues_[(index + offset) % size()];
+
+      {
+        std::lock_guard lock(victim.mutex);
+
+        if (victim.tasks.empty()) {
+          continue;
+        }
+
+        if (offset == 0) {
+          task = std::move(victim.tasks.back());
+          victim.tasks.pop_back();
+        } else {
+          task = std::move(victim.tasks.front());
+          victim.tasks.pop_front();
+        }
+      }
+
+      std::lock_guard lock(mutex_);
+      --queued_;
+      return true;
+    }
+
+    return false;
+  }
+
+  void work(std::size_t index) {
+    current() = {this, index};
+
+    while (true) {
+      std::function<void()> task;
+
+      if (pop(index, task)) {
+        task();
+        continue;
+      }
+
+      std::unique_lock lock(mutex_);
+      available_.wait(lock, [this] { return stopping_ || queued_ > 0; });
+
+      if (stopping_ && queued_ == 0) {
+        return;
+      }
+    }
+  }
+};
+} // namespace percy
+
+#endif
@@ -2,6 +2,7 @@
 #define PERCY_TYPE_TRAITS
 
 #include <type_traits>
+#include <utility>
 
 namespace percy {
 // Forward declaration.
@@ -44,6 +45,175 @@ constexpr inline bool is_sequence_v = is_sequence<Subject>::value;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Forward declaration.
+struct commit;
+
+template <typename Rule>
+struct and_;
+
+template <typename Rule>
+struct not_;
+
+template <typename Rule>
+struct is_silent {
+  constexpr static bool value = false;
+};
+
+template <>
+struct is_silent<commit> {
+  constexpr static bool value = true;
+};
+
+template <typename Rule>
+struct is_silent<and_<Rule>> {
+  constexpr static bool value = true;
+};
+
+template <typename Rule>
+struct is_silent<not_<Rule>> {
+  constexpr static bool value = true;
+};
+
+/// Determines whether the value of Rule is left out of the values of a sequence.
+template <typename Rule>
+constexpr inline bool is_silent_v = is_silent<Rule>::value;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Forward declaration.
+template <typename Operand, typename Level, typename... Levels>
+struct operators;
+
+template <typename Subject>
+struct is_operators {
+  constexpr static bool value = false;
+};
+
+template <typename Operand, typename Level, typename... Levels>
+struct is_operators<operators<Operand, Level, Levels...>> {
+  constexpr static bool value = true;
+};
+
+/// Determines whether Subject is operators.
+template <typename Subject>
+constexpr inline bool is_operators_v = is_operators<Subject>::value;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename Input, typename Enabled = void>
+struct has_context {
+  constexpr static bool value = false;
+};
+
+template <typename Input>
+struct has_context<Input, std::void_t<decltype(std::declval<const Input &>().context())>> {
+  constexpr static bool value = true;
+};
+
+/// Determines whether Input carries a parse context.
+template <typename Input>
+constexpr inline bool has_context_v = has_context<Input>::value;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename Input, typename Enabled = void>
+struct has_profiler {
+  constexpr static bool value = false;
+};
+
+template <typename Input>
+struct has_profiler<Input,
+                    std::void_t<decltype(std::declval<const Input &>().context().profiler())>> {
+  constexpr static bool value = true;
+};
+
+/// Determines whether Input carries a parse context profiling the rules.
+template <typename Input>
+constexpr inline bool has_profiler_v = has_profiler<Input>::value;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename Input, typename Enabled = void>
+struct records_expectations {
+  constexpr static bool value = false;
+};
+
+template <typename Input>
+struct records_expectations<
+    Input, std::void_t<decltype(std::declval<const Input &>().context().expected())>> {
+  constexpr static bool value = true;
+};
+
+/// Determines whether Input carries a parse context recording what failed terminals expected.
+template <typename Input>
+constexpr inline bool records_expectations_v = records_expectations<Input>::value;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename Input, typename Enabled = void>
+struct has_remaining {
+  constexpr static bool value = false;
+};
+
+template <typename Input>
+struct has_remaining<Input, std::void_t<decltype(std::declval<const Input &>().remaining())>> {
+  constexpr static bool value = true;
+};
+
+/// Determines whether Input exposes the content not consumed yet as contiguous memory.
+template <typename Input>
+constexpr inline bool has_remaining_v = has_remaining<Input>::value;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename Input, typename Enabled = void>
+struct tracks_examined {
+  constexpr static bool value = false;
+};
+
+template <typename Input>
+struct tracks_examined<Input, std::void_t<decltype(std::declval<const Input &>().examined())>> {
+  constexpr static bool value = true;
+};
+
+/// Determines whether Input records the extent of the input examined by parsers.
+template <typename Input>
+constexpr inline bool tracks_examined_v = tracks_examined<Input>::value;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename Input, typename Enabled = void>
+struct releases_on_commit {
+  constexpr static bool value = false;
+};
+
+template <typename Input>
+struct releases_on_commit<Input, std::void_t<decltype(std::declval<Input &>().commit())>> {
+  constexpr static bool value = true;
+};
+
+/// Determines whether Input releases the content before its location when the parse commits there.
+template <typename Input>
+constexpr inline bool releases_on_commit_v = releases_on_commit<Input>::value;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename Rule, typename Enabled = void>
+struct has_rule {
+  constexpr static bool value = false;
+};
+
+template <typename Rule>
+struct has_rule<Rule, std::void_t<typename Rule::rule>> {
+  constexpr static bool value = true;
+};
+
+/// Determines whether Rule is a custom rule defined in terms of another rule.
+template <typename Rule>
+constexpr inline bool has_rule_v = has_rule<Rule>::value;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 /// The value type of a result type.
 template <typename Result>
 using result_value_t = typename Result::success_type::value_type;
@@ -82,6 +252,24 @@ using action_return_t = typename action_return<Rule>::type;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+template <typename Enabled, typename Rule, typename Input, typename... Values>
+struct accepts_context {
+  constexpr static bool value = false;
+};
+
+template <typename Rule, typename Input, typename... Values>
+struct accepts_context<std::void_t<decltype(Rule::action(std::declval<const Input &>().context(),
+                                                         std::declval<Values>()...))>,
+                       Rule, Input, Values...> {
+  constexpr static bool value = true;
+};
+
+/// Determines whether the action of Rule takes the parse context of Input before the values.
+template <typename Rule, typename Input, typename... Values>
+constexpr inline bool accepts_context_v = accepts_context<void, Rule, Input, Values...>::value;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 template <typename... Ts>
 struct are_same_impl;
 
@@ -156,17 +344,29 @@ constexpr inline bool has_same_v = has_same<U, Ts...>::value;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-template <std::size_t Index, typename... Ts>
-struct at_index;
-
-template <typename T, typename... Ts>
-struct at_index<0, T, Ts...> {
+namespace detail {
+template <std::size_t Index, typename T>
+struct indexed {
   using type = T;
 };
 
-template <std::size_t Index, typename T, typename... Ts>
-struct at_index<Index, T, Ts...> {
-  using type = typename at_index<Index - 1, Ts...>::type;
+template <typename Indices, typename... Ts>
+struct indexed_list;
+
+template <std::size_t... Indices, typename... Ts>
+struct indexed_list<std::index_sequence<Indices...>, Ts...> : indexed<Indices, Ts>... {};
+
+template <std::size_t Index, typename T>
+indexed<Index, T> select(const indexed<Index, T> &);
+} // namespace detail
+
+/// Looks the type up among the bases of a single list instantiation instead of peeling Ts.
+template <std::size_t Index, typename... Ts>
+struct at_index {
+  static_assert(Index < sizeof...(Ts), "The index is out of bounds of the type list.");
+
+  using list_type = detail::indexed_list<std::index_sequence_for<Ts...>, Ts...>;
+  using type = typename decltype(detail::select<Index>(std::declval<list_type>()))::type;
 };
 
 /// The type at given index in the type list Ts.
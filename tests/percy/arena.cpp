@@ -0,0 +1,115 @@
+#include "testing.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <percy/arena.hpp>
+
+namespace {
+struct node {
+  int value;
+  const node *next;
+
+  constexpr node(int v, const node *n) : value(v), next(n) {}
+};
+
+struct counted {
+  int *destroyed;
+
+  constexpr explicit counted(int *d) : destroyed(d) {}
+  constexpr ~counted() { ++*destroyed; }
+};
+} // namespace
+
+TEST_CASE("Arena constructs nodes across chunks.", "[arena]") {
+  PERCY_CONSTEXPR auto sum = [] {
+    percy::arena<node, 4> nodes;
+    const node *list = nullptr;
+
+    for (int i = 1; i <= 10; ++i) {
+      list = nodes.make(i, list);
+    }
+
+    int total = 0;
+    for (auto it = list; it; it = it->next) {
+      total += it->value;
+    }
+
+    return nodes.size() == 10 ? total : 0;
+  }();
+
+  STATIC_REQUIRE(sum == 55);
+}
+
+TEST_CASE("Arena destroys all nodes at once.", "[arena]") {
+  PERCY_CONSTEXPR auto destroyed = [] {
+    int count = 0;
+
+    {
+      percy::arena<counted, 2> nodes;
+      nodes.make(&count);
+      nodes.make(&count);
+      nodes.make(&count);
+    }
+
+    return count;
+  }();
+
+  STATIC_REQUIRE(destroyed == 3);
+}
+
+TEST_CASE("Arena reuses its memory after being cleared.", "[arena]") {
+  int count = 0;
+  percy::arena<counted, 2> nodes;
+
+  auto first = nodes.make(&count);
+  nodes.make(&count);
+  nodes.make(&count);
+  nodes.clear();
+
+  REQUIRE(count == 3);
+  REQUIRE(nodes.size() == 0);
+  REQUIRE(nodes.make(&count) == first);
+
+  auto moved = std::move(nodes);
+
+  REQUIRE(moved.size() == 1);
+  REQUIRE(nodes.size() == 0);
+}
+
+TEST_CASE("Fixed arena constructs nodes in its own buffer.", "[arena]") {
+  PERCY_CONSTEXPR auto sum = [] {
+    percy::fixed_arena<node, 10> nodes;
+    const node *list = nullptr;
+
+    for (int i = 1; i <= 10; ++i) {
+      list = nodes.make(i, list);
+    }
+
+    int total = 0;
+    for (auto it = list; it; it = it->next) {
+      total += it->value;
+    }
+
+    return nodes.size() == nodes.capacity() ? total : 0;
+  }();
+
+  STATIC_REQUIRE(sum == 55);
+}
+
+TEST_CASE("Fixed arena destroys all nodes at once.", "[arena]") {
+  PERCY_CONSTEXPR auto destroyed = [] {
+    int count = 0;
+
+    {
+      percy::fixed_arena<counted, 4> nodes;
+      nodes.make(&count);
+      nodes.make(&count);
+      nodes.clear();
+      nodes.make(&count);
+    }
+
+    return count;
+  }();
+
+  STATIC_REQUIRE(destroyed == 3);
+}
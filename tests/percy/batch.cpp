@@ -0,0 +1,111 @@
+#include "testing.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <percy/batch.hpp>
+
+#include <percy/arena.hpp>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+using letter = percy::memo<percy::either<percy::symbol<'a'>, percy::symbol<'b'>>>;
+using message = percy::sequence<letter, percy::many<percy::range<'0', '9'>>, percy::end>;
+
+struct message_context : percy::context {
+  std::size_t parsed = 0;
+};
+
+struct counted_message {
+  using rule = message;
+
+  static std::size_t action(message_context &ctx, char, std::vector<char>, percy::eof) {
+    return ++ctx.parsed;
+  }
+};
+
+struct arena_context : percy::context {
+  percy::arena<std::vector<char>> digits;
+};
+
+struct arena_message {
+  using rule = message;
+
+  static const std::vector<char> *action(arena_context &ctx, char, std::vector<char> digits,
+                                         percy::eof) {
+    return ctx.digits.make(std::move(digits));
+  }
+};
+} // namespace
+
+TEST_CASE("Batch parser returns results in the order of the texts.", "[batch]") {
+  std::vector<std::string> texts;
+
+  for (std::size_t i = 0; i < 1000; ++i) {
+    texts.push_back((i % 2 == 0 ? "a" : "b") + std::to_string(i) + (i % 7 == 0 ? "x" : ""));
+  }
+
+  percy::batch_parser<message> batch(4);
+  auto results = batch.parse(texts);
+
+  REQUIRE(results.size() == texts.size());
+
+  for (std::size_t i = 0; i < texts.size(); ++i) {
+    auto expected = percy::parser<message>::parse(percy::input(texts[i]));
+
+    REQUIRE(results[i].is_success() == expected.is_success());
+
+    if (expected.is_success()) {
+      REQUIRE(results[i]->end() == texts[i].size());
+      REQUIRE(std::get<0>(results[i]->get()) == texts[i][0]);
+    }
+  }
+}
+
+TEST_CASE("Batch parser reuses contexts of its workers.", "[batch]") {
+  std::vector<std::string_view> texts(500, "a42");
+
+  percy::batch_parser<counted_message, message_context> batch(3);
+
+  REQUIRE(batch.parse(texts).size() == 500);
+  REQUIRE(batch.parse(texts).size() == 500);
+
+  std::size_t parsed = 0;
+  batch.for_each_context([&](message_context &ctx) { parsed += ctx.parsed; });
+
+  REQUIRE(parsed == 1000);
+}
+
+TEST_CASE("Thread pool runs tasks submitted from its workers.", "[batch][thread_pool]") {
+  percy::thread_pool pool(2);
+
+  auto outer = pool.submit([&pool] {
+    auto on_worker = percy::thread_pool::is_worker() && pool.worker_index() < pool.size();
+    return std::make_pair(on_worker, pool.submit([] { return 42; }));
+  });
+
+  auto [on_worker, inner] = outer.get();
+
+  REQUIRE(on_worker);
+  REQUIRE(inner.get() == 42);
+  REQUIRE(!percy::thread_pool::is_worker());
+  REQUIRE(pool.worker_index() == pool.size());
+}
+
+TEST_CASE("Batch parser keeps results of batches parsed on workers.", "[batch][thread_pool]") {
+  std::vector<std::string> texts(100, "a12345678901234567890");
+
+  percy::batch_parser<arena_message, arena_context> batch(2);
+  percy::thread_pool pool(2);
+
+  auto results = pool.submit([&] { return batch.parse(texts); }).get();
+
+  REQUIRE(results.size() == texts.size());
+
+  for (auto &result : results) {
+    REQUIRE(result.is_success());
+    REQUIRE(result->get()->size() == 20);
+  }
+}
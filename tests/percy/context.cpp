@@ -0,0 +1,54 @@
+#include "testing.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <percy/context.hpp>
+
+#include <percy/input.hpp>
+
+TEST_CASE("Context input forwards to the underlying input.", "[context][context_input]") {
+  PERCY_CONSTEXPR auto location = [] {
+    percy::context ctx;
+    auto input = percy::with_context(percy::input("abc"), ctx).advanced_by(1);
+    return input.peek() == 'b' && !input.ended() ? input.loc().get() : 0;
+  }();
+
+  STATIC_REQUIRE(location == 1);
+}
+
+TEST_CASE("Context input keeps the context when advanced.", "[context][context_input]") {
+  percy::context ctx;
+  auto input = percy::with_context(percy::input("abc"), ctx).advanced_to(percy::input_location(3));
+
+  REQUIRE(input.ended());
+  REQUIRE(&input.context() == &ctx);
+}
+
+TEST_CASE("Memo table finds inserted entries.", "[context][memo_table]") {
+  PERCY_CONSTEXPR auto found = [] {
+    percy::memo_table table;
+    table.insert<char>(percy::input_location(3), 42);
+    auto entry = table.find<char, int>(percy::input_location(3));
+    return entry ? *entry : 0;
+  }();
+
+  STATIC_REQUIRE(found == 42);
+}
+
+TEST_CASE("Memo table distinguishes rules and locations.", "[context][memo_table]") {
+  percy::memo_table table;
+
+  for (std::size_t i = 0; i < 100; ++i) {
+    table.insert<char>(percy::input_location(i), int(i));
+  }
+
+  REQUIRE(table.size() == 100);
+  REQUIRE(*table.find<char, int>(percy::input_location(57)) == 57);
+  REQUIRE(table.find<bool, int>(percy::input_location(57)) == nullptr);
+  REQUIRE(table.find<char, int>(percy::input_location(100)) == nullptr);
+
+  table.clear();
+
+  REQUIRE(table.size() == 0);
+  REQUIRE(table.find<char, int>(percy::input_location(57)) == nullptr);
+}
@@ -0,0 +1,138 @@
+#include "testing.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <percy/first_set.hpp>
+
+#include <percy/input.hpp>
+#include <percy/parser.hpp>
+
+#include <string_view>
+
+namespace {
+struct xy {
+  constexpr static std::string_view string = "xy";
+};
+
+struct empty {
+  constexpr static std::string_view string = "";
+};
+
+struct digits {
+  using rule = percy::sequence<percy::range<'0', '9'>, percy::many<percy::range<'0', '9'>>>;
+};
+
+struct nested;
+
+struct nested {
+  using rule = percy::one_of<percy::sequence<percy::symbol<'('>, nested>, percy::symbol<'x'>>;
+  using result = int;
+  static int action(std::tuple<char, int>);
+  static int action(char);
+};
+
+struct looping;
+
+struct looping {
+  using rule = percy::sequence<percy::many<percy::symbol<' '>>, looping>;
+};
+} // namespace
+
+TEST_CASE("First set of terminal rules.", "[first_set]") {
+  using percy::first_set_of_v;
+
+  STATIC_REQUIRE(first_set_of_v<percy::symbol<'a'>>.admits('a'));
+  STATIC_REQUIRE(!first_set_of_v<percy::symbol<'a'>>.admits('b'));
+  STATIC_REQUIRE(!first_set_of_v<percy::symbol<'a'>>.admits_end());
+
+  STATIC_REQUIRE(first_set_of_v<percy::range<'b', 'd'>>.admits('c'));
+  STATIC_REQUIRE(!first_set_of_v<percy::range<'b', 'd'>>.admits('e'));
+
+  STATIC_REQUIRE(first_set_of_v<percy::word<xy>>.admits('x'));
+  STATIC_REQUIRE(!first_set_of_v<percy::word<xy>>.admits('y'));
+  STATIC_REQUIRE(first_set_of_v<percy::word<empty>>.nullable());
+
+  STATIC_REQUIRE(first_set_of_v<percy::keywords<xy, empty>>.admits('x'));
+  STATIC_REQUIRE(first_set_of_v<percy::keywords<xy, empty>>.nullable());
+  STATIC_REQUIRE(!first_set_of_v<percy::keywords<xy>>.admits('y'));
+
+  STATIC_REQUIRE(first_set_of_v<percy::end>.admits_end());
+  STATIC_REQUIRE(!first_set_of_v<percy::end>.admits('a'));
+}
+
+TEST_CASE("First set of composite rules.", "[first_set]") {
+  using percy::first_set_of_v;
+  using percy::many;
+  using percy::sequence;
+  using percy::symbol;
+
+  using optional_prefix = sequence<many<symbol<'-'>>, symbol<'a'>>;
+
+  STATIC_REQUIRE(first_set_of_v<optional_prefix>.admits('-'));
+  STATIC_REQUIRE(first_set_of_v<optional_prefix>.admits('a'));
+  STATIC_REQUIRE(!first_set_of_v<optional_prefix>.admits('b'));
+  STATIC_REQUIRE(!first_set_of_v<optional_prefix>.nullable());
+
+  STATIC_REQUIRE(first_set_of_v<percy::either<symbol<'a'>, symbol<'b'>>>.admits('b'));
+  STATIC_REQUIRE(first_set_of_v<many<symbol<'a'>>>.admits('z'));
+}
+
+TEST_CASE("First set of custom and recursive rules.", "[first_set]") {
+  using percy::first_set_of_v;
+
+  STATIC_REQUIRE(first_set_of_v<digits>.admits('7'));
+  STATIC_REQUIRE(!first_set_of_v<digits>.admits('a'));
+
+  STATIC_REQUIRE(first_set_of_v<nested>.admits('('));
+  STATIC_REQUIRE(first_set_of_v<nested>.admits('x'));
+  STATIC_REQUIRE(!first_set_of_v<nested>.admits('y'));
+
+  STATIC_REQUIRE(first_set_of_v<looping>.admits('y'));
+}
+
+TEST_CASE("First set of lookahead predicates.", "[first_set]") {
+  using percy::first_set_of_v;
+
+  using followed = percy::sequence<percy::and_<percy::symbol<'a'>>, percy::range<'a', 'z'>>;
+  using unless = percy::sequence<percy::not_<percy::symbol<'a'>>, percy::range<'a', 'z'>>;
+
+  STATIC_REQUIRE(first_set_of_v<followed>.admits('a'));
+  STATIC_REQUIRE(!first_set_of_v<followed>.admits('b'));
+  STATIC_REQUIRE(first_set_of_v<unless>.admits('b'));
+  STATIC_REQUIRE(!first_set_of_v<unless>.nullable());
+}
+
+TEST_CASE("First set of rules committing before consuming input.", "[first_set][commit]") {
+  using percy::first_set_of_v;
+
+  using committed = percy::sequence<percy::commit, percy::symbol<'a'>>;
+  using prefixed = percy::sequence<percy::symbol<'a'>, percy::commit, percy::symbol<'b'>>;
+  using other = percy::sequence<percy::symbol<'b'>>;
+
+  STATIC_REQUIRE(first_set_of_v<committed>.admits('b'));
+  STATIC_REQUIRE(first_set_of_v<committed>.admits_end());
+  STATIC_REQUIRE(!first_set_of_v<prefixed>.admits('b'));
+
+  // Trying the alternatives in order commits before the other one gets a chance.
+  constexpr auto result = percy::parser<percy::either<committed, other>>::parse(percy::input("b"));
+
+  STATIC_REQUIRE(result.is_failure());
+  STATIC_REQUIRE(result.failure().committed());
+}
+
+TEST_CASE("Choice dispatch selects the only viable alternative.", "[first_set][dispatch]") {
+  using dispatch = percy::choice_dispatch<percy::symbol<'a'>, percy::range<'0', '9'>, percy::end>;
+
+  STATIC_REQUIRE(dispatch::single(dispatch::viable(percy::input("a"))) == 0);
+  STATIC_REQUIRE(dispatch::single(dispatch::viable(percy::input("5"))) == 1);
+  STATIC_REQUIRE(dispatch::single(dispatch::viable(percy::input(""))) == 2);
+  STATIC_REQUIRE(dispatch::viable(percy::input("x")) == 0);
+}
+
+TEST_CASE("Choice dispatch keeps overlapping alternatives.", "[first_set][dispatch]") {
+  using dispatch = percy::choice_dispatch<percy::symbol<'a'>, percy::range<'a', 'z'>>;
+
+  STATIC_REQUIRE(dispatch::viable(percy::input("a")) == 0b11);
+  STATIC_REQUIRE(dispatch::single(dispatch::viable(percy::input("a"))) == 2);
+  STATIC_REQUIRE(dispatch::single(dispatch::viable(percy::input("b"))) == 1);
+}
@@ -0,0 +1,102 @@
+#include "testing.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <percy/incremental.hpp>
+#include <percy/input.hpp>
+#include <percy/parser.hpp>
+
+#include <string>
+#include <vector>
+
+namespace {
+int statement_calls = 0;
+
+/// Digits terminated by a semicolon, producing their count.
+struct statement {
+  using rule = percy::sequence<percy::many<percy::range<'0', '9'>>, percy::symbol<';'>>;
+
+  static std::size_t action(std::vector<char> digits, char) {
+    ++statement_calls;
+    return digits.size();
+  }
+};
+
+using program = percy::many<percy::memo<statement>>;
+
+std::vector<std::size_t> parse(const std::string &text, percy::incremental_context &ctx) {
+  auto input = percy::with_incremental_context(percy::input(text), ctx);
+  auto result = percy::parser<program>::parse(input);
+  REQUIRE(result.is_success());
+  REQUIRE(result->end() == text.size());
+  return result->get();
+}
+} // namespace
+
+TEST_CASE("Incremental parse reuses results untouched by the edit.", "[incremental]") {
+  percy::incremental_context ctx;
+  std::string text = "1;22;333;4444;";
+
+  statement_calls = 0;
+  REQUIRE(parse(text, ctx) == std::vector<std::size_t>{1, 2, 3, 4});
+  REQUIRE(statement_calls == 4);
+
+  percy::edit change{5, 1, "55"};
+  change.apply(text);
+  ctx.apply(change);
+
+  statement_calls = 0;
+  REQUIRE(text == "1;22;5533;4444;");
+  REQUIRE(parse(text, ctx) == std::vector<std::size_t>{1, 2, 4, 4});
+  REQUIRE(statement_calls == 1);
+}
+
+TEST_CASE("Incremental parse reparses results whose lookahead was edited.", "[incremental]") {
+  percy::incremental_context ctx;
+  std::string text = "1;22;";
+
+  parse(text, ctx);
+
+  // The many of the second statement examined the semicolon right after the digits.
+  percy::edit change{4, 0, "2"};
+  change.apply(text);
+  ctx.apply(change);
+
+  statement_calls = 0;
+  REQUIRE(parse(text, ctx) == std::vector<std::size_t>{1, 3});
+  REQUIRE(statement_calls == 1);
+}
+
+TEST_CASE("Incremental parse handles edits at the end of the text.", "[incremental]") {
+  percy::incremental_context ctx;
+  std::string text = "1;22;";
+
+  parse(text, ctx);
+
+  percy::edit change{5, 0, "7;"};
+  change.apply(text);
+  ctx.apply(change);
+
+  statement_calls = 0;
+  REQUIRE(parse(text, ctx) == std::vector<std::size_t>{1, 2, 1});
+  REQUIRE(statement_calls == 1);
+}
+
+TEST_CASE("Memo table drops and moves entries on edits.", "[incremental][memo_table]") {
+  PERCY_CONSTEXPR auto kept = [] {
+    percy::memo_table table;
+    table.insert<char>(percy::input_location(0), 0, 2);
+    table.insert<char>(percy::input_location(2), 2, 5);
+    table.insert<char>(percy::input_location(5), 5, 8);
+    table.insert<char>(percy::input_location(8), 8);
+
+    table.apply_edit(3, 2, 4);
+
+    auto before = table.find<char, int>(percy::input_location(0));
+    auto after = table.find<char, int>(percy::input_location(7));
+
+    return table.size() == 3 && before && *before == 0 && after && *after == 5;
+  }();
+
+  STATIC_REQUIRE(kept);
+}
@@ -43,3 +43,17 @@ TEST_CASE("Non-empty input advanced to end.", "[inputs][input]") {
   STATIC_REQUIRE(input.ended());
   STATIC_REQUIRE(input.loc() == 2);
 }
+
+TEST_CASE("Input exposes the remaining content.", "[inputs][input]") {
+  PERCY_CONSTEXPR auto input = percy::input("abc").advanced_by(1);
+
+  STATIC_REQUIRE(input.remaining() == "bc");
+  STATIC_REQUIRE(input.advanced_by(2).remaining().empty());
+}
+
+TEST_CASE("Input exposes the content covered by a span.", "[inputs][input]") {
+  PERCY_CONSTEXPR auto input = percy::input("abcd").advanced_by(3);
+
+  STATIC_REQUIRE(input.slice({percy::input_location(1), 2}) == "bc");
+  STATIC_REQUIRE(input.slice({percy::input_location(4), 0}).empty());
+}
@@ -0,0 +1,67 @@
+#include "testing.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <percy/mapped_file.hpp>
+#include <percy/parser.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#if __has_include(<sys/mman.h>)
+namespace {
+/// File in the temporary directory, removed at the end of the test.
+struct temporary_file {
+  std::filesystem::path path;
+
+  temporary_file(const char *name, const std::string &content)
+      : path(std::filesystem::temp_directory_path() / name) {
+    std::ofstream(path, std::ios::binary) << content;
+  }
+
+  ~temporary_file() { std::filesystem::remove(path); }
+};
+} // namespace
+
+TEST_CASE("Mapped file exposes the content of the file.", "[inputs][mapped_file]") {
+  temporary_file file("percy_mapped_file_content.txt", "abc");
+
+  auto mapped = percy::mapped_file::open(file.path.c_str());
+
+  REQUIRE(mapped.has_value());
+  REQUIRE(mapped->content() == "abc");
+  REQUIRE(mapped->input().peek() == 'a');
+}
+
+TEST_CASE("Mapped file of an empty file has no content.", "[inputs][mapped_file]") {
+  temporary_file file("percy_mapped_file_empty.txt", "");
+
+  auto mapped = percy::mapped_file::open(file.path.c_str());
+
+  REQUIRE(mapped.has_value());
+  REQUIRE(mapped->content().empty());
+  REQUIRE(mapped->input().ended());
+}
+
+TEST_CASE("Mapped file fails to open missing files.", "[inputs][mapped_file]") {
+  REQUIRE(!percy::mapped_file::open("/nonexistent/percy/file.txt").has_value());
+}
+
+TEST_CASE("Captures of mapped input outlive the parse.", "[inputs][mapped_file]") {
+  using parser = percy::parser<percy::capture<percy::many<percy::range<'a', 'z'>>>>;
+
+  temporary_file file("percy_mapped_file_capture.txt", "words and more");
+
+  auto mapped = percy::mapped_file::open(file.path.c_str());
+  REQUIRE(mapped.has_value());
+
+  auto result = parser::parse(mapped->input());
+  auto moved = std::move(*mapped);
+
+  REQUIRE(result.is_success());
+  REQUIRE(result->get() == "words");
+  REQUIRE(moved.content().size() == 14);
+}
+#endif
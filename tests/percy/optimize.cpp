@@ -0,0 +1,189 @@
+#include "testing.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <percy/optimize.hpp>
+
+#include <percy/context.hpp>
+#include <percy/incremental.hpp>
+#include <percy/input.hpp>
+#include <percy/parser.hpp>
+
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace optimized {
+using digit = percy::range<'0', '9'>;
+using lower = percy::range<'a', 'z'>;
+using upper = percy::range<'A', 'Z'>;
+
+using word_char =
+    percy::either<percy::either<lower, upper>, percy::either<digit, percy::symbol<'_'>>>;
+
+using keyword_if =
+    percy::sequence<percy::symbol<'i'>, percy::symbol<'f'>, percy::symbol<' '>, digit>;
+using keyword_in =
+    percy::sequence<percy::symbol<'i'>, percy::symbol<'n'>, percy::symbol<' '>, digit>;
+using keywords = percy::either<keyword_if, keyword_in>;
+
+struct nested {
+  using rule = percy::sequence<percy::symbol<'('>, percy::many<nested>, percy::symbol<')'>>;
+
+  constexpr static int action(char, std::vector<int> children, char) {
+    int depth = 0;
+
+    for (auto child : children) {
+      depth = child > depth ? child : depth;
+    }
+
+    return depth + 1;
+  }
+};
+
+template <typename Rule>
+constexpr bool same_result_v =
+    std::is_same_v<percy::parser_result_t<Rule>, percy::parser_result_t<percy::optimize_t<Rule>>>;
+} // namespace optimized
+
+TEST_CASE("Optimizer preserves the results of rules.", "[optimize]") {
+  STATIC_REQUIRE(optimized::same_result_v<optimized::word_char>);
+  STATIC_REQUIRE(optimized::same_result_v<optimized::keywords>);
+  STATIC_REQUIRE(optimized::same_result_v<optimized::keyword_if>);
+  STATIC_REQUIRE(optimized::same_result_v<optimized::nested>);
+  STATIC_REQUIRE(optimized::same_result_v<percy::many<optimized::keywords>>);
+  STATIC_REQUIRE(optimized::same_result_v<percy::capture<optimized::keyword_if>>);
+  STATIC_REQUIRE(optimized::same_result_v<
+                 percy::sequence<percy::symbol<'a'>, percy::commit, percy::symbol<'b'>>>);
+}
+
+TEST_CASE("Optimizer rewrites choices and sequences.", "[optimize]") {
+  using percy::symbol;
+
+  STATIC_REQUIRE(std::is_same_v<percy::optimize_t<optimized::digit>, optimized::digit>);
+
+  STATIC_REQUIRE(std::is_same_v<
+                 percy::optimize_t<optimized::word_char>,
+                 percy::char_set<percy::either<optimized::lower, optimized::upper, optimized::digit,
+                                               symbol<'_'>>>>);
+
+  STATIC_REQUIRE(std::is_same_v<percy::optimize_t<optimized::keyword_if>,
+                                percy::spliced_sequence<percy::symbols<'i', 'f', ' '>,
+                                                        optimized::digit>>);
+
+  using tail_f = percy::spliced_sequence<percy::symbols<'f', ' '>, optimized::digit>;
+  using tail_n = percy::spliced_sequence<percy::symbols<'n', ' '>, optimized::digit>;
+
+  STATIC_REQUIRE(std::is_same_v<percy::optimize_t<optimized::keywords>,
+                                percy::factored<percy::sequence<symbol<'i'>>,
+                                                percy::either<tail_f, tail_n>>>);
+
+  STATIC_REQUIRE(std::is_same_v<percy::optimize_t<optimized::nested>,
+                                percy::optimized_rule<optimized::nested>>);
+  using children = percy::many<percy::optimized_rule<optimized::nested>>;
+
+  STATIC_REQUIRE(std::is_same_v<percy::optimized_rule<optimized::nested>::rule,
+                                percy::sequence<symbol<'('>, children, symbol<')'>>>);
+}
+
+TEST_CASE("Optimizer flattens sequences whose values are not used.", "[optimize]") {
+  using percy::symbol;
+
+  using rule = percy::capture<
+      percy::sequence<symbol<'a'>, percy::sequence<symbol<'b'>, symbol<'c'>>, optimized::digit>>;
+
+  STATIC_REQUIRE(std::is_same_v<
+                 percy::optimize_t<rule>,
+                 percy::capture<percy::spliced_sequence<percy::symbols<'a', 'b', 'c'>,
+                                                        optimized::digit>>>);
+
+  PERCY_CONSTEXPR auto result = percy::parser<percy::optimize_t<rule>>::match(percy::input("abc1"));
+  STATIC_REQUIRE(result.is_success());
+  STATIC_REQUIRE(result->end() == 4);
+}
+
+TEST_CASE("Optimized character sets parse like the choices they replace.", "[optimize]") {
+  using original = percy::parser<optimized::word_char>;
+  using optimized = percy::parser<percy::optimize_t<optimized::word_char>>;
+
+  for (std::string_view text : {"a", "Q", "7", "_", "-", ""}) {
+    percy::context original_ctx;
+    percy::context optimized_ctx;
+
+    auto expected = original::parse(percy::with_context(percy::input(text), original_ctx));
+    auto result = optimized::parse(percy::with_context(percy::input(text), optimized_ctx));
+
+    REQUIRE(result.is_success() == expected.is_success());
+
+    if (expected.is_success()) {
+      REQUIRE(result->get() == expected->get());
+      REQUIRE(result->end().get() == expected->end().get());
+    } else {
+      REQUIRE(result.failure().loc().get() == expected.failure().loc().get());
+      REQUIRE(optimized_ctx.expected().size() == original_ctx.expected().size());
+    }
+  }
+}
+
+TEST_CASE("Optimized runs of symbols produce each symbol.", "[optimize]") {
+  using parser = percy::parser<percy::optimize_t<optimized::keyword_if>>;
+
+  PERCY_CONSTEXPR auto result = parser::parse(percy::input("if 4"));
+  STATIC_REQUIRE(result.is_success());
+  STATIC_REQUIRE(result->get() == std::make_tuple('i', 'f', ' ', '4'));
+  STATIC_REQUIRE(result->end() == 4);
+
+  PERCY_CONSTEXPR auto failure = parser::parse(percy::input("ix 4"));
+  STATIC_REQUIRE(failure.is_failure());
+  STATIC_REQUIRE(failure.failure().loc() == 1);
+
+  // Inputs not exposing the remaining text get compared symbol by symbol.
+  percy::incremental_context ctx;
+
+  auto incremental = parser::parse(percy::with_incremental_context(percy::input("ix 4"), ctx));
+  REQUIRE(incremental.is_failure());
+  REQUIRE(incremental.failure().loc() == 1);
+  REQUIRE(ctx.examined() == 2);
+  REQUIRE(ctx.expected().loc() == 1);
+  REQUIRE(ctx.expected().contains("f"));
+}
+
+TEST_CASE("Optimized choices parse their common prefix once.", "[optimize]") {
+  using parser = percy::parser<percy::optimize_t<optimized::keywords>>;
+
+  PERCY_CONSTEXPR auto in = parser::parse(percy::input("in 2"));
+  STATIC_REQUIRE(in.is_success());
+  STATIC_REQUIRE(in->get() == std::make_tuple('i', 'n', ' ', '2'));
+
+  PERCY_CONSTEXPR auto failure = parser::match(percy::input("io 2"));
+  STATIC_REQUIRE(failure.is_failure());
+  STATIC_REQUIRE(failure.failure().loc() == 1);
+}
+
+TEST_CASE("Optimized choices keep committed failures.", "[optimize][commit]") {
+  using percy::symbol;
+
+  using rule = percy::either<percy::sequence<symbol<'i'>, percy::commit, symbol<'f'>>,
+                             percy::sequence<symbol<'i'>, symbol<'x'>>>;
+  using parser = percy::parser<percy::optimize_t<rule>>;
+
+  // Factoring out the prefix would let the choice skip the committed rest on the input.
+  STATIC_REQUIRE(std::is_same_v<
+                 percy::optimize_t<rule>,
+                 percy::either<percy::sequence<symbol<'i'>, percy::commit, symbol<'f'>>,
+                               percy::spliced_sequence<percy::symbols<'i', 'x'>>>>);
+
+  PERCY_CONSTEXPR auto result = parser::match(percy::input("ix"));
+  STATIC_REQUIRE(result.is_failure());
+  STATIC_REQUIRE(result.failure().committed());
+}
+
+TEST_CASE("Optimized recursive rules keep their actions.", "[optimize]") {
+  using parser = percy::parser<percy::optimize_t<optimized::nested>>;
+
+  PERCY_CONSTEXPR auto result = parser::parse(percy::input("(()(()))"));
+  STATIC_REQUIRE(result.is_success());
+  STATIC_REQUIRE(result->get() == 3);
+  STATIC_REQUIRE(result->end() == 8);
+}
@@ -0,0 +1,145 @@
+#include "testing.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <percy/parallel_many.hpp>
+
+#include <percy/input.hpp>
+#include <percy/parser.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+struct number_line {
+  using rule = percy::sequence<percy::capture<percy::many<percy::range<'0', '9'>>>,
+                               percy::symbol<'\n'>>;
+
+  static std::size_t action(std::string_view digits, char) { return digits.size(); }
+};
+
+using bracketed_item = percy::either<percy::range<'0', '9'>, percy::symbol<'\n'>>;
+
+struct bracketed {
+  using rule = percy::sequence<percy::symbol<'['>, percy::capture<percy::many<bracketed_item>>,
+                               percy::symbol<']'>, percy::symbol<'\n'>>;
+
+  static std::size_t action(char, std::string_view content, char, char) { return content.size(); }
+};
+
+struct committed_bracketed {
+  using rule = percy::sequence<percy::symbol<'['>, percy::commit,
+                               percy::capture<percy::many<bracketed_item>>, percy::symbol<']'>,
+                               percy::symbol<'\n'>>;
+
+  static std::size_t action(char, std::string_view content, char, char) { return content.size(); }
+};
+
+/// Occurrences end after a run of newlines, so a chunk split after the first newline of a run
+/// ends its last occurrence earlier than a sequential parse does.
+struct paragraph {
+  using rule = percy::sequence<percy::capture<percy::many<percy::range<'a', 'z'>>>,
+                               percy::symbol<'\n'>, percy::many<percy::symbol<'\n'>>>;
+
+  static std::size_t action(std::string_view letters, char, std::vector<char> newlines) {
+    return letters.size() * 10 + newlines.size();
+  }
+};
+
+template <typename Rule>
+void require_same_as_many(const std::string &text) {
+  auto parallel =
+      percy::parser<percy::parallel_many<Rule, percy::symbol<'\n'>>>::parse(percy::input(text));
+  auto sequential = percy::parser<percy::many<Rule>>::parse(percy::input(text));
+
+  REQUIRE(parallel.is_success() == sequential.is_success());
+
+  if (sequential.is_success()) {
+    REQUIRE(parallel->end().get() == sequential->end().get());
+    REQUIRE(parallel->get() == sequential->get());
+  } else {
+    REQUIRE(parallel.failure().loc().get() == sequential.failure().loc().get());
+    REQUIRE(parallel.failure().committed() == sequential.failure().committed());
+  }
+}
+} // namespace
+
+TEST_CASE("Parser parallel_many parses the same as many.", "[parser][parallel_many]") {
+  std::string text;
+
+  for (std::size_t i = 0; text.size() < 1 << 20; ++i) {
+    text += std::to_string(i * 7919 % 100000) + "\n";
+  }
+
+  auto parallel = percy::parser<percy::parallel_many<number_line, percy::symbol<'\n'>>>::parse(
+      percy::input(text));
+  auto sequential = percy::parser<percy::many<number_line>>::parse(percy::input(text));
+
+  REQUIRE(parallel.is_success());
+  REQUIRE(parallel->end() == text.size());
+  REQUIRE(parallel->get() == sequential->get());
+}
+
+TEST_CASE("Parser parallel_many reports global locations of the stop.", "[parser][parallel_many]") {
+  std::string text;
+
+  while (text.size() < 1 << 20) {
+    text += "12345\n";
+  }
+
+  auto stop = text.size() / 2 + 1;
+  text[stop] = 'x';
+
+  auto parallel = percy::parser<percy::parallel_many<number_line, percy::symbol<'\n'>>>::parse(
+      percy::input(text));
+  auto sequential = percy::parser<percy::many<number_line>>::parse(percy::input(text));
+
+  REQUIRE(parallel.is_success());
+  REQUIRE(parallel->end().get() == sequential->end().get());
+  REQUIRE(parallel->end().get() < stop);
+  REQUIRE(parallel->get() == sequential->get());
+}
+
+TEST_CASE("Parser parallel_many recovers from delimiters inside occurrences.",
+          "[parser][parallel_many]") {
+  std::string text;
+
+  while (text.size() < 1 << 20) {
+    text += "[12\n34\n5678]\n";
+  }
+
+  require_same_as_many<bracketed>(text);
+}
+
+TEST_CASE("Parser parallel_many recovers from occurrences extending past chunks.",
+          "[parser][parallel_many]") {
+  std::string text;
+
+  for (std::size_t i = 0; text.size() < 1 << 20; ++i) {
+    text += std::string(i % 5 + 1, 'a') + std::string(i % 3 + 1, '\n');
+  }
+
+  require_same_as_many<paragraph>(text);
+}
+
+TEST_CASE("Parser parallel_many ignores committed failures of truncated chunks.",
+          "[parser][parallel_many][commit]") {
+  std::string text;
+
+  while (text.size() < 1 << 20) {
+    text += "[12\n34\n5678]\n";
+  }
+
+  require_same_as_many<committed_bracketed>(text);
+
+  // A letter inside the brackets fails the occurrence after its commit.
+  text[text.find('5', text.size() / 2)] = 'x';
+  require_same_as_many<committed_bracketed>(text);
+
+  auto failure =
+      percy::parser<percy::parallel_many<committed_bracketed, percy::symbol<'\n'>>>::parse(
+          percy::input(text));
+  REQUIRE(failure.is_failure());
+  REQUIRE(failure.failure().committed());
+}
@@ -4,8 +4,14 @@
 
 #include <percy/parser.hpp>
 
+#include <percy/arena.hpp>
+#include <percy/context.hpp>
 #include <percy/input.hpp>
 
+#include <memory>
+#include <string>
+#include <vector>
+
 TEST_CASE("Parser end succeeds on input end.", "[parser][end]") {
   using parser = percy::parser<percy::end>;
 
@@ -138,6 +144,78 @@ TEST_CASE("Parser word fails on input end.", "[parser][word]") {
   STATIC_REQUIRE(result.failure().loc() == 0);
 }
 
+TEST_CASE("Parser word succeeds on matching string in generic input.", "[parser][word]") {
+  using parser = percy::parser<percy::word<ab>>;
+
+  percy::context ctx;
+  auto result = parser::parse(percy::with_context(percy::input("xabc", 1), ctx));
+
+  REQUIRE(result.is_success());
+  REQUIRE(result->begin() == 1);
+  REQUIRE(result->end() == 3);
+}
+
+struct kw_if {
+  constexpr static std::string_view string = "if";
+};
+
+struct kw_in {
+  constexpr static std::string_view string = "in";
+};
+
+struct kw_int {
+  constexpr static std::string_view string = "int";
+};
+
+struct kw_interface {
+  constexpr static std::string_view string = "interface";
+};
+
+using keywords = percy::keywords<kw_interface, kw_in, kw_if, kw_int>;
+
+TEST_CASE("Parser keywords succeeds on the longest matching keyword.", "[parser][keywords]") {
+  using parser = percy::parser<keywords>;
+
+  PERCY_CONSTEXPR auto in = parser::parse(percy::input("inx"));
+  PERCY_CONSTEXPR auto integer = parser::parse(percy::input("int"));
+  PERCY_CONSTEXPR auto interface = parser::parse(percy::input("interface;"));
+
+  STATIC_REQUIRE(in.is_success());
+  STATIC_REQUIRE(in->end() == 2);
+  STATIC_REQUIRE(in->get() == std::string_view("in"));
+
+  STATIC_REQUIRE(integer.is_success());
+  STATIC_REQUIRE(integer->end() == 3);
+  STATIC_REQUIRE(integer->get() == std::string_view("int"));
+
+  STATIC_REQUIRE(interface.is_success());
+  STATIC_REQUIRE(interface->end() == 9);
+  STATIC_REQUIRE(interface->get() == std::string_view("interface"));
+}
+
+TEST_CASE("Parser keywords falls back to a shorter keyword.", "[parser][keywords]") {
+  using parser = percy::parser<keywords>;
+
+  PERCY_CONSTEXPR auto result = parser::parse(percy::input("xinterf", 1));
+
+  STATIC_REQUIRE(result.is_success());
+  STATIC_REQUIRE(result->begin() == 1);
+  STATIC_REQUIRE(result->end() == 4);
+  STATIC_REQUIRE(result->get() == std::string_view("int"));
+}
+
+TEST_CASE("Parser keywords fails when no keyword matches.", "[parser][keywords]") {
+  using parser = percy::parser<keywords>;
+
+  PERCY_CONSTEXPR auto different = parser::parse(percy::input("else"));
+  PERCY_CONSTEXPR auto prefix = parser::parse(percy::input("i"));
+
+  STATIC_REQUIRE(different.is_failure());
+  STATIC_REQUIRE(different.failure().loc() == 0);
+  STATIC_REQUIRE(prefix.is_failure());
+  STATIC_REQUIRE(prefix.failure().loc() == 0);
+}
+
 TEST_CASE("Parser sequence succeeds when all rules match.", "[parser][sequence]") {
   using parser = percy::parser<percy::sequence<percy::symbol<'a'>, percy::symbol<'b'>>>;
 
@@ -167,24 +245,121 @@ TEST_CASE("Parser sequence fails when following rule does not match.", "[parser]
   STATIC_REQUIRE(result.failure().loc() == 1);
 }
 
-static testing::context ctx();
-
 namespace percy {
-struct parser<testing::tracker1> {
-  using result_type = result<eof>;
+template <>
+struct parser<testing::tracked> {
+  using result_type = result<testing::tracker1>;
 
+  template <typename Input>
   constexpr static result_type parse(Input input) {
-    return succeed(testing::tracker1(&ctx), {input.loc(), input.loc() + 1});
+    if (input.ended()) {
+      return fail("Tracked.", input.loc());
+    }
+
+    return succeed(testing::tracker1(input.context()), {input.loc(), input.loc() + 1});
   }
 };
+} // namespace percy
+
+template <typename Rule>
+constexpr testing::event_log track_parse(std::string_view text) {
+  return testing::capture_events([text](testing::context& ctx) {
+    percy::parser<Rule>::parse(percy::with_context(percy::input(text), ctx));
+  });
 }
 
+struct tracked_pair {
+  using rule = percy::sequence<testing::tracked, testing::tracked>;
+
+  constexpr static int action(testing::tracker1, testing::tracker1) {
+    return 42;
+  }
+};
+
 TEST_CASE("Parser sequence correctly handles lifetimes.", "[parser][sequence]") {
-  using parser = percy::parser<percy::sequence<testing::tracker1>>;
+  PERCY_CONSTEXPR auto events = track_parse<percy::sequence<testing::tracked>>("xxx");
 
-  PERCY_CONSTEXPR auto result - parser::parse(percy::input("xxx"));
+  STATIC_REQUIRE(events.count(testing::event::event_type_ids::ec) == 1);
+  STATIC_REQUIRE(events.copies() == 0);
+  STATIC_REQUIRE(events.moves() == 7);
+}
 
-  //
+TEST_CASE("Parsers move values of rules instead of copying them.", "[parser]") {
+  using namespace testing;
+
+  PERCY_CONSTEXPR auto single = track_parse<tracked>("xxx");
+  PERCY_CONSTEXPR auto sequence = track_parse<percy::sequence<tracked, tracked, tracked>>("xxx");
+  PERCY_CONSTEXPR auto either = track_parse<percy::either<tracked, tracked>>("xxx");
+  PERCY_CONSTEXPR auto one_of = track_parse<percy::one_of<percy::symbol<'y'>, tracked>>("xxx");
+  PERCY_CONSTEXPR auto many = track_parse<percy::many<tracked>>("xxx");
+  PERCY_CONSTEXPR auto action = track_parse<tracked_pair>("xxx");
+
+  // A value is moved into the success and into the result holding it.
+  STATIC_REQUIRE(single.copies() == 0);
+  STATIC_REQUIRE(single.moves() == 2);
+
+  // Each value then moves out of its result, into the slot of the sequence and into the tuple,
+  // which moves into the success and the result like any value.
+  STATIC_REQUIRE(sequence.count(event::event_type_ids::ec) == 3);
+  STATIC_REQUIRE(sequence.copies() == 0);
+  STATIC_REQUIRE(sequence.moves() == 3 * 7);
+
+  // Choices move the result of the alternative once more to return it.
+  STATIC_REQUIRE(either.copies() == 0);
+  STATIC_REQUIRE(either.moves() == 3);
+
+  // The value of one_of moves out of the result of the alternative into a variant, which moves
+  // into the success, the result and the returned result.
+  STATIC_REQUIRE(one_of.copies() == 0);
+  STATIC_REQUIRE(one_of.moves() == 7);
+
+  // Each value moves out of its result into the vector, which moves without moving its values.
+  // Growing the vector to two and then four values moves the three first values.
+  STATIC_REQUIRE(many.count(event::event_type_ids::ec) == 3);
+  STATIC_REQUIRE(many.copies() == 0);
+  STATIC_REQUIRE(many.moves() == 3 * 4 + 3);
+
+  // The values move out of the result of the sequence and into the parameters of the action.
+  STATIC_REQUIRE(action.copies() == 0);
+  STATIC_REQUIRE(action.moves() == 2 * 9);
+}
+
+namespace percy {
+template <>
+struct parser<std::unique_ptr<int>> {
+  using result_type = result<std::unique_ptr<int>>;
+
+  template <typename Input>
+  static result_type parse(Input input) {
+    if (input.ended()) {
+      return fail("Unique.", input.loc());
+    }
+
+    return succeed(std::make_unique<int>(input.peek()), {input.loc(), input.loc() + 1});
+  }
+};
+} // namespace percy
+
+struct unique_sum {
+  using rule = percy::sequence<std::unique_ptr<int>, std::unique_ptr<int>>;
+
+  static int action(std::unique_ptr<int> lhs, std::unique_ptr<int> rhs) {
+    return *lhs + *rhs;
+  }
+};
+
+TEST_CASE("Parsers support move-only values.", "[parser]") {
+  using unique = std::unique_ptr<int>;
+
+  auto sequence = percy::parser<percy::sequence<unique, unique>>::parse(percy::input("ab"));
+  auto one_of = percy::parser<percy::one_of<percy::symbol<'x'>, unique>>::parse(percy::input("ab"));
+  auto many = percy::parser<percy::many<unique>>::parse(percy::input("ab"));
+  auto action = percy::parser<unique_sum>::parse(percy::input("ab"));
+
+  REQUIRE(*std::get<1>(sequence->get()) == 'b');
+  REQUIRE(*percy::get<unique>(one_of->get()) == 'a');
+  REQUIRE(many->get().size() == 2);
+  REQUIRE(action->get() == 'a' + 'b');
 }
 
 TEST_CASE("Parser either succeeds when first rule matches.", "[parser][either]") {
@@ -218,6 +393,245 @@ TEST_CASE("Parser either fails when no rule matches.", "[parser][either]") {
   STATIC_REQUIRE(result.failure().loc() == 0);
 }
 
+TEST_CASE("Parser either falls back to ordered trial on overlapping alternatives.",
+          "[parser][either]") {
+  using parser = percy::parser<
+      percy::either<percy::sequence<percy::symbol<'a'>, percy::symbol<'b'>>,
+                    percy::sequence<percy::symbol<'a'>, percy::symbol<'c'>>,
+                    percy::sequence<percy::symbol<'x'>, percy::symbol<'c'>>>>;
+
+  PERCY_CONSTEXPR auto result = parser::parse(percy::input("ac"));
+
+  STATIC_REQUIRE(result.is_success());
+  STATIC_REQUIRE(result->end() == 2);
+  STATIC_REQUIRE(result->get() == std::tuple<char, char>('a', 'c'));
+}
+
+TEST_CASE("Parser either reports the furthest failure of its alternatives.", "[parser][either]") {
+  using parser = percy::parser<
+      percy::either<percy::sequence<percy::symbol<'a'>, percy::symbol<'b'>>,
+                    percy::sequence<percy::symbol<'a'>, percy::range<'0', '9'>>,
+                    percy::sequence<percy::symbol<'x'>, percy::symbol<'c'>>>>;
+
+  PERCY_CONSTEXPR auto result = parser::parse(percy::input("ad"));
+  PERCY_CONSTEXPR auto matched = parser::match(percy::input("ad"));
+
+  STATIC_REQUIRE(result.is_failure());
+  STATIC_REQUIRE(result.failure().loc() == 1);
+  STATIC_REQUIRE(matched.is_failure());
+  STATIC_REQUIRE(matched.failure().loc() == 1);
+}
+
+TEST_CASE("Parser either records the expectations of its alternatives.", "[parser][either]") {
+  using parser = percy::parser<
+      percy::either<percy::sequence<percy::symbol<'a'>, percy::symbol<'b'>>,
+                    percy::sequence<percy::symbol<'a'>, percy::range<'0', '9'>>,
+                    percy::sequence<percy::symbol<'x'>, percy::symbol<'c'>>>>;
+
+  PERCY_CONSTEXPR auto expected = [] {
+    percy::context ctx;
+    parser::parse(percy::with_context(percy::input("ad"), ctx));
+    return ctx.expected();
+  }();
+
+  STATIC_REQUIRE(expected.loc() == 1);
+  STATIC_REQUIRE(expected.size() == 2);
+  STATIC_REQUIRE(expected.contains("b"));
+  STATIC_REQUIRE(expected.contains("0-9"));
+
+  PERCY_CONSTEXPR auto matched = [] {
+    percy::context ctx;
+    parser::match(percy::with_context(percy::input("ad"), ctx));
+    return ctx.expected();
+  }();
+
+  STATIC_REQUIRE(matched.size() == 2);
+}
+
+TEST_CASE("Parser either records the expectations of alternatives it skips.", "[parser][either]") {
+  using bracketed = percy::sequence<percy::symbol<'('>, percy::symbol<'x'>, percy::symbol<')'>>;
+  using parser = percy::parser<
+      percy::either<bracketed, percy::sequence<percy::symbol<'{'>, percy::symbol<'x'>,
+                                               percy::symbol<'}'>>>>;
+
+  PERCY_CONSTEXPR auto expected = [] {
+    percy::context ctx;
+    parser::parse(percy::with_context(percy::input("x"), ctx));
+    return ctx.expected();
+  }();
+
+  STATIC_REQUIRE(expected.loc() == 0);
+  STATIC_REQUIRE(expected.size() == 2);
+  STATIC_REQUIRE(expected.contains("("));
+  STATIC_REQUIRE(expected.contains("{"));
+
+  PERCY_CONSTEXPR auto single = [] {
+    percy::context ctx;
+    parser::parse(percy::with_context(percy::input("(y"), ctx));
+    return ctx.expected();
+  }();
+
+  STATIC_REQUIRE(single.loc() == 1);
+  STATIC_REQUIRE(single.size() == 1);
+  STATIC_REQUIRE(single.contains("x"));
+
+  PERCY_CONSTEXPR auto matched = [] {
+    percy::context ctx;
+    parser::match(percy::with_context(percy::input("x"), ctx));
+    return ctx.expected();
+  }();
+
+  STATIC_REQUIRE(matched.size() == 2);
+}
+
+TEST_CASE("Parser either fails when no alternative can start on the input.", "[parser][either]") {
+  using parser = percy::parser<percy::either<percy::symbol<'a'>, percy::symbol<'b'>>>;
+
+  PERCY_CONSTEXPR auto result = parser::parse(percy::input("abc", 3));
+
+  STATIC_REQUIRE(result.is_failure());
+  STATIC_REQUIRE(result.failure().loc() == 3);
+}
+
+template <std::size_t... Indices>
+constexpr auto wide_either(std::index_sequence<Indices...>)
+    -> percy::either<percy::symbol<static_cast<char>('!' + Indices)>...>;
+
+template <std::size_t... Indices>
+constexpr auto wide_sequence(std::index_sequence<Indices...>)
+    -> percy::sequence<percy::symbol<static_cast<char>('a' + Indices % 26)>...>;
+
+TEST_CASE("Parser either succeeds on the last of more alternatives than dispatched.",
+          "[parser][either]") {
+  using parser = percy::parser<decltype(wide_either(std::make_index_sequence<70>()))>;
+
+  PERCY_CONSTEXPR auto result = parser::parse(percy::input("f"));
+  PERCY_CONSTEXPR auto failure = parser::parse(percy::input("g"));
+
+  STATIC_REQUIRE(result.is_success());
+  STATIC_REQUIRE(result->end() == 1);
+  STATIC_REQUIRE(failure.is_failure());
+}
+
+TEST_CASE("Parser sequence parses long sequences.", "[parser][sequence]") {
+  using parser = percy::parser<decltype(wide_sequence(std::make_index_sequence<30>()))>;
+
+  PERCY_CONSTEXPR auto text = "abcdefghijklmnopqrstuvwxyzabcd";
+  PERCY_CONSTEXPR auto result = parser::parse(percy::input(text));
+  PERCY_CONSTEXPR auto value = [&] {
+    auto copy = parser::parse(percy::input(text));
+    return copy->get();
+  }();
+
+  STATIC_REQUIRE(result.is_success());
+  STATIC_REQUIRE(result->end() == 30);
+  STATIC_REQUIRE(std::get<0>(value) == 'a');
+  STATIC_REQUIRE(std::get<29>(value) == 'd');
+  STATIC_REQUIRE(parser::match(percy::input(text)).is_success());
+  STATIC_REQUIRE(parser::parse(percy::input("abcdefghijklmnopqrstuvwxyzabcx")).is_failure());
+}
+
+using committed_if = percy::sequence<percy::symbol<'i'>, percy::commit, percy::symbol<'f'>>;
+
+namespace committing {
+struct block {
+  using rule = percy::sequence<percy::symbol<'{'>, percy::many<block>, percy::commit,
+                               percy::symbol<'}'>>;
+  constexpr static int action(char, std::vector<int>, char) { return 0; }
+};
+
+struct plain {
+  using rule = percy::sequence<percy::symbol<'('>, percy::many<plain>, percy::symbol<')'>>;
+  constexpr static int action(char, std::vector<int>, char) { return 0; }
+};
+} // namespace committing
+
+TEST_CASE("Rules containing commit markers are told apart.", "[parser][commit]") {
+  STATIC_REQUIRE(percy::may_commit_v<committed_if>);
+  STATIC_REQUIRE(percy::may_commit_v<percy::many<
+                     percy::either<percy::sequence<percy::symbol<'x'>, percy::symbol<'y'>>,
+                                   committed_if>>>);
+  STATIC_REQUIRE(percy::may_commit_v<committing::block>);
+  STATIC_REQUIRE(percy::may_commit_v<percy::memo<committing::block>>);
+
+  STATIC_REQUIRE_FALSE(percy::may_commit_v<percy::symbol<'a'>>);
+  STATIC_REQUIRE_FALSE(percy::may_commit_v<committing::plain>);
+  STATIC_REQUIRE_FALSE(percy::may_commit_v<percy::many<percy::one_of<committing::plain>>>);
+}
+
+TEST_CASE("Parser sequence leaves the commit marker out of its values.", "[parser][commit]") {
+  using parser = percy::parser<committed_if>;
+
+  PERCY_CONSTEXPR auto result = parser::parse(percy::input("if"));
+
+  using value_type = percy::result_value_t<parser::result_type>;
+
+  STATIC_REQUIRE(std::is_same_v<value_type, std::tuple<char, char>>);
+  STATIC_REQUIRE(result.is_success());
+  STATIC_REQUIRE(result->end() == 2);
+  STATIC_REQUIRE(parser::parse(percy::input("if"))->get() == std::tuple<char, char>('i', 'f'));
+}
+
+TEST_CASE("Parser sequence commits to failures after the commit marker.", "[parser][commit]") {
+  using parser = percy::parser<committed_if>;
+
+  PERCY_CONSTEXPR auto before = parser::parse(percy::input("x"));
+  PERCY_CONSTEXPR auto after = parser::parse(percy::input("ix"));
+  PERCY_CONSTEXPR auto matched = parser::match(percy::input("ix"));
+
+  STATIC_REQUIRE(!before.failure().committed());
+  STATIC_REQUIRE(after.failure().committed());
+  STATIC_REQUIRE(after.failure().loc() == 1);
+  STATIC_REQUIRE(matched.failure().committed());
+}
+
+TEST_CASE("Parser either tries no alternative after a committed failure.", "[parser][commit]") {
+  using parser = percy::parser<
+      percy::either<committed_if, percy::sequence<percy::symbol<'i'>, percy::symbol<'x'>>>>;
+
+  PERCY_CONSTEXPR auto result = parser::parse(percy::input("ix"));
+  PERCY_CONSTEXPR auto matched = parser::match(percy::input("ix"));
+
+  STATIC_REQUIRE(result.is_failure());
+  STATIC_REQUIRE(result.failure().committed());
+  STATIC_REQUIRE(result.failure().loc() == 1);
+  STATIC_REQUIRE(matched.is_failure());
+  STATIC_REQUIRE(parser::parse(percy::input("if")).is_success());
+}
+
+TEST_CASE("Parser many fails on a committed failure.", "[parser][commit]") {
+  using parser = percy::parser<percy::many<
+      percy::either<percy::sequence<percy::symbol<'a'>, percy::commit, percy::symbol<'b'>>,
+                    percy::sequence<percy::symbol<'c'>, percy::symbol<'d'>>>>>;
+
+  PERCY_CONSTEXPR auto committed = parser::parse(percy::input("abcdax")).failure();
+  PERCY_CONSTEXPR auto uncommitted = parser::match(percy::input("abcdcx"));
+
+  STATIC_REQUIRE(committed.committed());
+  STATIC_REQUIRE(committed.loc() == 5);
+  STATIC_REQUIRE(parser::match(percy::input("abcdax")).is_failure());
+  STATIC_REQUIRE(uncommitted.is_success());
+  STATIC_REQUIRE(uncommitted->end() == 4);
+}
+
+TEST_CASE("Parser commit releases memoized results before it.", "[parser][commit]") {
+  using statement = percy::sequence<percy::symbol<'s'>, percy::commit, percy::symbol<';'>>;
+  using parser = percy::parser<percy::many<percy::memo<statement>>>;
+
+  std::string text;
+
+  for (int i = 0; i < 1000; ++i) {
+    text += "s;";
+  }
+
+  percy::context ctx;
+  auto result = parser::parse(percy::with_context(percy::input(text), ctx));
+
+  REQUIRE(result.is_success());
+  REQUIRE(result->end() == text.size());
+  REQUIRE(ctx.memo().size() <= 16);
+}
+
 struct abc {
   constexpr static std::string_view string = "abc";
 };
@@ -253,6 +667,39 @@ TEST_CASE("Parser one_of fails when no rule matches.", "[parser][one_of]") {
   STATIC_REQUIRE(result.failure().loc() == 0);
 }
 
+TEST_CASE("Parser one_of reports the failure of the furthest alternative.", "[parser][one_of]") {
+  using parser = percy::parser<
+      percy::one_of<percy::word<abc>, percy::sequence<percy::symbol<'a'>, percy::symbol<'x'>>>>;
+
+  PERCY_CONSTEXPR auto result = parser::parse(percy::input("ab"));
+
+  STATIC_REQUIRE(result.is_failure());
+  STATIC_REQUIRE(result.failure().loc() == 1);
+  STATIC_REQUIRE(result.failure().message() == "Expected symbol.");
+
+  PERCY_CONSTEXPR auto expected = [] {
+    percy::context ctx;
+    parser::parse(percy::with_context(percy::input("ab"), ctx));
+    return ctx.expected();
+  }();
+
+  STATIC_REQUIRE(expected.size() == 1);
+  STATIC_REQUIRE(expected.contains("x"));
+}
+
+TEST_CASE("Parser one_of jumps to the alternative by the first character.", "[parser][one_of]") {
+  using parser = percy::parser<
+      percy::one_of<percy::word<abc>, percy::range<'0', '9'>, percy::end>>;
+
+  PERCY_CONSTEXPR auto digit = parser::parse(percy::input("7"));
+  PERCY_CONSTEXPR auto ended = parser::parse(percy::input(""));
+
+  STATIC_REQUIRE(digit.is_success());
+  STATIC_REQUIRE(percy::get<char>(digit->get()) == '7');
+  STATIC_REQUIRE(ended.is_success());
+  STATIC_REQUIRE(percy::holds_alternative<percy::eof>(ended->get()));
+}
+
 TEST_CASE("Parser many succeeds even when rule matches zero times.", "[parser][many]") {
   using parser = percy::parser<percy::many<percy::symbol<'x'>>>;
 
@@ -286,6 +733,224 @@ TEST_CASE("Parser many stops at the input end.", "[parser][many]") {
   REQUIRE(result->get() == std::vector<char>{'a', 'a', 'a'});
 }
 
+TEST_CASE("Parser many records the expectation where it stops.", "[parser][many]") {
+  using parser = percy::parser<
+      percy::sequence<percy::many<percy::range<'0', '9'>>, percy::symbol<';'>>>;
+
+  PERCY_CONSTEXPR auto expected = [] {
+    percy::context ctx;
+    parser::parse(percy::with_context(percy::input("12x"), ctx));
+    return ctx.expected();
+  }();
+
+  STATIC_REQUIRE(expected.loc() == 2);
+  STATIC_REQUIRE(expected.size() == 2);
+  STATIC_REQUIRE(expected.contains("0-9"));
+  STATIC_REQUIRE(expected.contains(";"));
+
+  PERCY_CONSTEXPR auto matched = [] {
+    percy::context ctx;
+    parser::match(percy::with_context(percy::input("12x"), ctx));
+    return ctx.expected();
+  }();
+
+  STATIC_REQUIRE(matched.size() == 2);
+  STATIC_REQUIRE(matched.contains("0-9"));
+}
+
+static int counted_calls = 0;
+
+struct counted {
+  using rule = percy::symbol<'a'>;
+  static auto action(percy::result<char> parsed) {
+    ++counted_calls;
+    return parsed->get();
+  }
+};
+
+using counted_choice =
+    percy::either<percy::sequence<percy::memo<counted>, percy::symbol<'x'>>,
+                  percy::sequence<percy::memo<counted>, percy::symbol<'y'>>>;
+
+TEST_CASE("Parser memo reuses results of the same rule at the same location.", "[parser][memo]") {
+  using parser = percy::parser<counted_choice>;
+
+  percy::context ctx;
+  counted_calls = 0;
+
+  auto result = parser::parse(percy::with_context(percy::input("ay"), ctx));
+
+  REQUIRE(result.is_success());
+  REQUIRE(result->end() == 2);
+  REQUIRE(result->get() == std::tuple<char, char>('a', 'y'));
+  REQUIRE(counted_calls == 1);
+  REQUIRE(ctx.memo().size() == 1);
+}
+
+TEST_CASE("Parser memo runs no actions when only recognizing.", "[parser][memo]") {
+  using lookahead = percy::parser<percy::and_<percy::memo<counted>>>;
+  using parser = percy::parser<
+      percy::sequence<percy::and_<percy::memo<counted>>, percy::memo<counted>>>;
+
+  percy::context ctx;
+  counted_calls = 0;
+
+  auto matched = lookahead::parse(percy::with_context(percy::input("a"), ctx));
+
+  REQUIRE(matched.is_success());
+  REQUIRE(counted_calls == 0);
+
+  // Recognizing and parsing memoize their results apart.
+  auto result = parser::parse(percy::with_context(percy::input("a"), ctx));
+
+  REQUIRE(result.is_success());
+  REQUIRE(result->get() == std::tuple<char>('a'));
+  REQUIRE(counted_calls == 1);
+  REQUIRE(ctx.memo().size() == 2);
+}
+
+TEST_CASE("Parser memo parses again without context.", "[parser][memo]") {
+  using parser = percy::parser<counted_choice>;
+
+  counted_calls = 0;
+
+  auto result = parser::parse(percy::input("ay"));
+
+  REQUIRE(result.is_success());
+  REQUIRE(counted_calls == 2);
+}
+
+TEST_CASE("Parser memo remembers failures.", "[parser][memo]") {
+  using parser = percy::parser<percy::memo<percy::symbol<'a'>>>;
+
+  PERCY_CONSTEXPR auto location = [] {
+    percy::context ctx;
+    auto input = percy::with_context(percy::input("b"), ctx);
+    auto first = parser::parse(input);
+    auto second = parser::parse(input);
+    return first.is_failure() && second.is_failure() && ctx.memo().size() == 1
+               ? second.failure().loc().get()
+               : 42;
+  }();
+
+  STATIC_REQUIRE(location == 0);
+}
+
+struct digit {
+  using rule = percy::range<'0', '9'>;
+  constexpr static int action(percy::result<char> parsed) { return parsed->get() - '0'; }
+};
+
+int difference_calls = 0;
+
+struct difference_expr;
+
+struct difference {
+  using rule = percy::sequence<percy::memo<difference_expr>, percy::symbol<'-'>, digit>;
+
+  static int action(int lhs, char, int rhs) {
+    ++difference_calls;
+    return lhs - rhs;
+  }
+};
+
+struct difference_expr {
+  using rule = percy::either<difference, digit>;
+  static int action(percy::result<int> parsed) { return parsed->get(); }
+};
+
+TEST_CASE("Parser memo grows left recursive rules.", "[parser][memo]") {
+  using parser = percy::parser<percy::memo<difference_expr>>;
+
+  percy::context ctx;
+  difference_calls = 0;
+
+  auto result = parser::parse(percy::with_context(percy::input("9-3-2-1+"), ctx));
+
+  REQUIRE(result.is_success());
+  REQUIRE(result->end() == 7);
+  REQUIRE(result->get() == 3);
+  REQUIRE(difference_calls == 3);
+}
+
+TEST_CASE("Parser memo recognizes left recursive rules.", "[parser][memo]") {
+  using parser = percy::parser<percy::capture<percy::memo<difference_expr>>>;
+
+  percy::context ctx;
+
+  difference_calls = 0;
+
+  auto result = parser::parse(percy::with_context(percy::input("9-3-"), ctx));
+
+  REQUIRE(result.is_success());
+  REQUIRE(result->get() == "9-3");
+  REQUIRE(difference_calls == 0);
+}
+
+struct indirect_expr;
+
+struct indirect_operand {
+  using rule = percy::memo<indirect_expr>;
+  constexpr static int action(percy::result<int> parsed) { return parsed->get(); }
+};
+
+struct indirect_difference {
+  using rule = percy::sequence<percy::memo<indirect_operand>, percy::symbol<'-'>, digit>;
+  constexpr static int action(int lhs, char, int rhs) { return lhs - rhs; }
+};
+
+struct indirect_expr {
+  using rule = percy::either<indirect_difference, digit>;
+  constexpr static int action(percy::result<int> parsed) { return parsed->get(); }
+};
+
+TEST_CASE("Parser memo grows indirectly left recursive rules.", "[parser][memo]") {
+  using parser = percy::parser<percy::memo<indirect_expr>>;
+
+  PERCY_CONSTEXPR auto value = [] {
+    percy::context ctx;
+    auto result = parser::parse(percy::with_context(percy::input("9-3-2"), ctx));
+    return result.is_success() && result->end() == 5 ? result->get() : -1;
+  }();
+
+  STATIC_REQUIRE(value == 4);
+}
+
+struct zero {
+  constexpr int operator()() const { return 0; }
+};
+
+struct add_digit {
+  constexpr int operator()(int sum, char digit) const { return sum + digit - '0'; }
+};
+
+TEST_CASE("Parser fold_many accumulates every repetition.", "[parser][fold_many]") {
+  using parser = percy::parser<percy::fold_many<percy::range<'0', '9'>, zero, add_digit>>;
+
+  PERCY_CONSTEXPR auto result = parser::parse(percy::input("1234x"));
+
+  STATIC_REQUIRE(result.is_success());
+  STATIC_REQUIRE(result->begin() == 0);
+  STATIC_REQUIRE(result->end() == 4);
+  STATIC_REQUIRE(result->get() == 10);
+}
+
+TEST_CASE("Parser fold_many succeeds with the initial value on no match.", "[parser][fold_many]") {
+  using count = percy::fold_many<percy::symbol<'a'>, decltype([] { return 5; }),
+                                 decltype([](int n, char) { return n + 1; })>;
+  using parser = percy::parser<count>;
+
+  PERCY_CONSTEXPR auto none = parser::parse(percy::input("b"));
+  PERCY_CONSTEXPR auto some = parser::parse(percy::input("aab"));
+
+  STATIC_REQUIRE(none.is_success());
+  STATIC_REQUIRE(none->end() == 0);
+  STATIC_REQUIRE(none->get() == 5);
+  STATIC_REQUIRE(some.is_success());
+  STATIC_REQUIRE(some->end() == 2);
+  STATIC_REQUIRE(some->get() == 7);
+}
+
 struct left_curly {
   using rule = percy::sequence<percy::symbol<'{'>>;
   constexpr static auto action(char l_curly) { return l_curly; }
@@ -319,6 +984,210 @@ TEST_CASE("Parser of custom rule fails when the inner rule fails.", "[parser][cu
   REQUIRE(result.failure().loc() == 0);
 }
 
+TEST_CASE("Parser capture succeeds with the matched text.", "[parser][capture]") {
+  using identifier = percy::sequence<percy::range<'a', 'z'>, percy::many<percy::range<'a', 'z'>>>;
+  using parser = percy::parser<percy::capture<identifier>>;
+
+  PERCY_CONSTEXPR auto result = parser::parse(percy::input(" abc1", 1));
+
+  STATIC_REQUIRE(result.is_success());
+  STATIC_REQUIRE(result->begin() == 1);
+  STATIC_REQUIRE(result->end() == 4);
+  STATIC_REQUIRE(result->get() == std::string_view("abc"));
+}
+
+TEST_CASE("Parser capture views into the original input.", "[parser][capture]") {
+  using parser = percy::parser<percy::capture<percy::many<percy::symbol<'x'>>>>;
+
+  std::string_view text = "xxy";
+  percy::context ctx;
+  auto result = parser::parse(percy::with_context(percy::input(text), ctx));
+
+  REQUIRE(result.is_success());
+
+  auto captured = result->get();
+
+  REQUIRE(captured.data() == text.data());
+  REQUIRE(captured.length() == 2);
+}
+
+TEST_CASE("Parser capture fails when the inner rule fails.", "[parser][capture]") {
+  using parser = percy::parser<percy::capture<percy::sequence<percy::symbol<'a'>, right_curly>>>;
+
+  auto result = parser::parse(percy::input("a{"));
+
+  REQUIRE(result.is_failure());
+  REQUIRE(result.failure().loc() == 1);
+}
+
+TEST_CASE("Parser and_ succeeds without consuming where the rule matches.",
+          "[parser][lookahead]") {
+  using parser = percy::parser<percy::and_<percy::word<ab>>>;
+
+  PERCY_CONSTEXPR auto success = parser::parse(percy::input("abc"));
+  PERCY_CONSTEXPR auto failure = parser::parse(percy::input("acb"));
+
+  STATIC_REQUIRE(success.is_success());
+  STATIC_REQUIRE(success->begin() == 0);
+  STATIC_REQUIRE(success->end() == 0);
+  STATIC_REQUIRE(failure.is_failure());
+  STATIC_REQUIRE(failure.failure().loc() == 0);
+}
+
+TEST_CASE("Parser not_ succeeds without consuming where the rule does not match.",
+          "[parser][lookahead]") {
+  using parser = percy::parser<percy::not_<percy::word<ab>>>;
+
+  PERCY_CONSTEXPR auto success = parser::parse(percy::input("acb"));
+  PERCY_CONSTEXPR auto failure = parser::parse(percy::input("abc"));
+
+  STATIC_REQUIRE(success.is_success());
+  STATIC_REQUIRE(success->end() == 0);
+  STATIC_REQUIRE(failure.is_failure());
+  STATIC_REQUIRE(failure.failure().loc() == 0);
+}
+
+TEST_CASE("Parser sequence leaves lookahead predicates out of its values.", "[parser][lookahead]") {
+  using identifier =
+      percy::sequence<percy::not_<percy::word<ab>>, percy::many<percy::range<'a', 'z'>>,
+                      percy::and_<percy::symbol<';'>>>;
+  using parser = percy::parser<identifier>;
+  using value_type = percy::result_value_t<parser::result_type>;
+
+  STATIC_REQUIRE(std::is_same_v<value_type, std::tuple<std::vector<char>>>);
+  STATIC_REQUIRE(parser::parse(percy::input("abc;")).is_failure());
+  STATIC_REQUIRE(parser::parse(percy::input("xyz")).is_failure());
+  STATIC_REQUIRE(parser::match(percy::input("xyz;"))->end() == 3);
+}
+
+TEST_CASE("Parser many repeats until a lookahead stops it.", "[parser][lookahead]") {
+  using parser = percy::parser<percy::capture<percy::many<
+      percy::sequence<percy::not_<percy::word<ab>>, percy::range<'a', 'z'>>>>>;
+
+  PERCY_CONSTEXPR auto result = parser::parse(percy::input("xyzabc"));
+
+  STATIC_REQUIRE(result.is_success());
+  STATIC_REQUIRE(result->get() == "xyz");
+}
+
+TEST_CASE("Parser lookahead predicates run no actions.", "[parser][lookahead]") {
+  counted_calls = 0;
+
+  auto success = percy::parser<percy::and_<counted>>::parse(percy::input("a"));
+  auto failure = percy::parser<percy::not_<counted>>::parse(percy::input("a"));
+
+  REQUIRE(success.is_success());
+  REQUIRE(failure.is_failure());
+  REQUIRE(counted_calls == 0);
+}
+
+struct arithmetic {
+  using rule =
+      percy::operators<digit, percy::level<percy::left, '+', '-'>,
+                       percy::level<percy::left, '*', '/'>, percy::level<percy::right, '^'>>;
+
+  constexpr static int action(int lhs, char symbol, int rhs) {
+    switch (symbol) {
+    case '+':
+      return lhs + rhs;
+    case '-':
+      return lhs - rhs;
+    case '*':
+      return lhs * rhs;
+    case '/':
+      return lhs / rhs;
+    default:
+      return rhs == 0 ? 1 : lhs * action(lhs, '^', rhs - 1);
+    }
+  }
+};
+
+TEST_CASE("Parser operators binds tighter levels first.", "[parser][operators]") {
+  using parser = percy::parser<arithmetic>;
+
+  PERCY_CONSTEXPR auto result = parser::parse(percy::input("1+2*3-4/2"));
+
+  STATIC_REQUIRE(result.is_success());
+  STATIC_REQUIRE(result->end() == 9);
+  STATIC_REQUIRE(parser::parse(percy::input("1+2*3-4/2"))->get() == 5);
+  STATIC_REQUIRE(parser::parse(percy::input("2*3^2"))->get() == 18);
+}
+
+TEST_CASE("Parser operators groups by the associativity of levels.", "[parser][operators]") {
+  using parser = percy::parser<arithmetic>;
+
+  STATIC_REQUIRE(parser::parse(percy::input("8-4-2"))->get() == 2);
+  STATIC_REQUIRE(parser::parse(percy::input("2^3^2"))->get() == 512);
+}
+
+TEST_CASE("Parser operators leaves an operator without operand unparsed.", "[parser][operators]") {
+  using parser = percy::parser<arithmetic>;
+
+  PERCY_CONSTEXPR auto single = parser::parse(percy::input("7"));
+  PERCY_CONSTEXPR auto dangling = parser::parse(percy::input("1+2*"));
+  PERCY_CONSTEXPR auto failure = parser::parse(percy::input("+1"));
+
+  STATIC_REQUIRE(single->end() == 1);
+  STATIC_REQUIRE(parser::parse(percy::input("7"))->get() == 7);
+  STATIC_REQUIRE(dangling->end() == 3);
+  STATIC_REQUIRE(parser::parse(percy::input("1+2*"))->get() == 3);
+  STATIC_REQUIRE(failure.is_failure());
+  STATIC_REQUIRE(failure.failure().loc() == 0);
+}
+
+TEST_CASE("Parser operators recognizes without an action.", "[parser][operators]") {
+  using parser = percy::parser<percy::capture<
+      percy::operators<percy::range<'0', '9'>, percy::level<percy::left, '+'>>>>;
+
+  PERCY_CONSTEXPR auto result = parser::parse(percy::input("1+2+3-4"));
+
+  STATIC_REQUIRE(result.is_success());
+  STATIC_REQUIRE(result->get() == "1+2+3");
+}
+
+TEST_CASE("Parser match recognizes input without running actions.", "[parser][match]") {
+  using parser = percy::parser<right_curly>;
+
+  auto success = parser::match(percy::input("}"));
+  auto failure = parser::match(percy::input("x"));
+
+  REQUIRE(success.is_success());
+  REQUIRE(success->begin() == 0);
+  REQUIRE(success->end() == 1);
+  REQUIRE(failure.is_failure());
+  REQUIRE(failure.failure().loc() == 0);
+}
+
+TEST_CASE("Parser match recognizes composite rules.", "[parser][match]") {
+  using parser = percy::parser<
+      percy::sequence<percy::symbol<'a'>, percy::many<percy::symbol<'b'>>,
+                      percy::one_of<percy::symbol<'c'>, percy::word<ab>>, percy::end>>;
+
+  PERCY_CONSTEXPR auto success = parser::match(percy::input("abbab"));
+  PERCY_CONSTEXPR auto failure = parser::match(percy::input("abbx"));
+
+  STATIC_REQUIRE(success.is_success());
+  STATIC_REQUIRE(success->begin() == 0);
+  STATIC_REQUIRE(success->end() == 5);
+  STATIC_REQUIRE(failure.is_failure());
+  STATIC_REQUIRE(failure.failure().loc() == 3);
+}
+
+TEST_CASE("Parser match agrees with parse on choices.", "[parser][match]") {
+  using parser = percy::parser<
+      percy::either<percy::sequence<percy::symbol<'a'>, percy::symbol<'b'>>,
+                    percy::sequence<percy::symbol<'a'>, percy::symbol<'c'>>>>;
+
+  PERCY_CONSTEXPR auto success = parser::match(percy::input("ac"));
+  PERCY_CONSTEXPR auto failure = parser::match(percy::input("ad"));
+
+  STATIC_REQUIRE(success.is_success());
+  STATIC_REQUIRE(success->end() == 2);
+  STATIC_REQUIRE(failure.is_failure());
+  STATIC_REQUIRE(failure.failure().loc() == 1);
+  STATIC_REQUIRE(parser::parse(percy::input("ad")).failure().loc() == 1);
+}
+
 struct stmt {
   using rule = percy::one_of<percy::symbol<'a'>, percy::many<percy::symbol<'x'>>>;
   using result = int;
@@ -342,3 +1211,50 @@ TEST_CASE("Blah.", "[parser][custom]") {
   REQUIRE(result_xs->end() == 2);
   REQUIRE(result_xs->get() == 1000);
 }
+
+struct digit_cell {
+  int digit;
+  const digit_cell *next;
+};
+
+struct digit_list_context : percy::context {
+  percy::arena<digit_cell> cells;
+};
+
+struct digit_list;
+
+struct digit_cons {
+  using rule = percy::sequence<percy::range<'0', '9'>, digit_list>;
+  constexpr static const digit_cell *action(digit_list_context &ctx, char digit,
+                                            const digit_cell *tail) {
+    return ctx.cells.make(digit - '0', tail);
+  }
+};
+
+struct digit_nil {
+  using rule = percy::sequence<percy::symbol<'.'>>;
+  constexpr static const digit_cell *action(char) { return nullptr; }
+};
+
+struct digit_list {
+  using rule = percy::either<digit_cons, digit_nil>;
+  constexpr static auto action(percy::result<const digit_cell *> list) { return list->get(); }
+};
+
+TEST_CASE("Parser passes the context to actions that accept it.", "[parser][custom][context]") {
+  using parser = percy::parser<digit_list>;
+
+  PERCY_CONSTEXPR auto sum = [] {
+    digit_list_context ctx;
+    auto result = parser::parse(percy::with_context(percy::input("123."), ctx));
+
+    int total = 0;
+    for (auto cell = result->get(); cell; cell = cell->next) {
+      total += cell->digit;
+    }
+
+    return ctx.cells.size() == 3 ? total : 0;
+  }();
+
+  STATIC_REQUIRE(sum == 6);
+}
@@ -0,0 +1,116 @@
+#include "testing.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <percy/profiler.hpp>
+
+#include <percy/input.hpp>
+#include <percy/parser.hpp>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace profiled {
+struct digit {
+  using rule = percy::range<'0', '9'>;
+  static int action(percy::result<char> parsed) { return parsed->get() - '0'; }
+};
+
+struct letter {
+  using rule = percy::range<'a', 'z'>;
+  static char action(percy::result<char> parsed) { return parsed->get(); }
+};
+
+struct item {
+  using rule = percy::one_of<digit, letter>;
+  using result = int;
+
+  static int action(int value) { return value; }
+  static int action(char) { return 0; }
+};
+
+struct items {
+  using rule = percy::sequence<percy::many<item>, percy::symbol<'.'>>;
+  static int action(std::vector<int> values, char) { return static_cast<int>(values.size()); }
+};
+
+const percy::rule_profile &find(const std::vector<percy::rule_profile> &profiles,
+                                std::string_view name) {
+  auto it = std::find_if(profiles.begin(), profiles.end(),
+                         [name](const auto &profile) { return profile.name == name; });
+  REQUIRE(it != profiles.end());
+  return *it;
+}
+} // namespace profiled
+
+TEST_CASE("Type name spells the type.", "[profiler]") {
+  STATIC_REQUIRE(percy::type_name<int>() == "int");
+  STATIC_REQUIRE(percy::type_name<profiled::digit>() == "profiled::digit");
+  STATIC_REQUIRE(percy::type_name<percy::symbol<']'>>().ends_with("symbol<']'>"));
+}
+
+TEST_CASE("Profiler records the invocations of custom rules.", "[profiler]") {
+  percy::profiling_context ctx;
+
+  auto result =
+      percy::parser<profiled::items>::parse(percy::with_context(percy::input("1a2."), ctx));
+
+  REQUIRE(result.is_success());
+  REQUIRE(result->get() == 3);
+
+  auto profiles = ctx.profiler().profiles();
+
+  REQUIRE(profiles.size() == 4);
+
+  // Alternatives that cannot start on the input are only invoked for their expectations once the
+  // choice fails, which happens on the final period.
+  auto &digit = profiled::find(profiles, "profiled::digit");
+  REQUIRE(digit.invocations == 3);
+  REQUIRE(digit.successes == 2);
+  REQUIRE(digit.failures == 1);
+  REQUIRE(digit.consumed == 2);
+
+  auto &letter = profiled::find(profiles, "profiled::letter");
+  REQUIRE(letter.invocations == 2);
+  REQUIRE(letter.successes == 1);
+
+  auto &item = profiled::find(profiles, "profiled::item");
+  REQUIRE(item.invocations == 4);
+  REQUIRE(item.successes == 3);
+  REQUIRE(item.failures == 1);
+
+  auto &items = profiled::find(profiles, "profiled::items");
+  REQUIRE(items.invocations == 1);
+  REQUIRE(items.consumed == 4);
+  REQUIRE(items.time >= item.time);
+}
+
+TEST_CASE("Profiler merges statistics and reports rules by name.", "[profiler]") {
+  percy::profiling_context first;
+  percy::profiling_context second;
+
+  percy::parser<profiled::items>::parse(percy::with_context(percy::input("12."), first));
+  percy::parser<profiled::items>::parse(percy::with_context(percy::input("3."), second));
+
+  first.profiler().merge(second.profiler());
+
+  auto profiles = first.profiler().profiles();
+  REQUIRE(profiled::find(profiles, "profiled::items").invocations == 2);
+  REQUIRE(profiled::find(profiles, "profiled::digit").successes == 3);
+
+  std::ostringstream report;
+  first.profiler().report(report);
+
+  REQUIRE(report.str().find("profiled::items") != std::string::npos);
+  REQUIRE(report.str().find("invocations") != std::string::npos);
+}
+
+TEST_CASE("Parsing without a profiler records nothing.", "[profiler]") {
+  percy::context ctx;
+
+  STATIC_REQUIRE(!percy::has_profiler_v<decltype(percy::with_context(percy::input(""), ctx))>);
+  STATIC_REQUIRE(percy::has_profiler_v<
+                 percy::context_input<percy::input, percy::profiling_context>>);
+}
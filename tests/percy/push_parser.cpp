@@ -0,0 +1,153 @@
+#include "testing.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <percy/push_parser.hpp>
+
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace {
+using bracketed = percy::sequence<percy::symbol<'['>, percy::many<percy::range<'0', '9'>>,
+                                  percy::symbol<']'>>;
+
+int item_calls = 0;
+
+struct item {
+  using rule = percy::sequence<percy::range<'a', 'z'>, percy::symbol<';'>>;
+
+  static char action(char letter, char) {
+    ++item_calls;
+    return letter;
+  }
+};
+
+using items = percy::sequence<percy::many<percy::memo<item>>, percy::symbol<'.'>>;
+
+struct tagged {
+  using rule = percy::sequence<percy::symbol<'<'>, percy::many<item>, percy::symbol<'>'>>;
+
+  static std::size_t action(char, std::vector<char> letters, char) { return letters.size(); }
+};
+
+std::size_t peeks = 0;
+
+struct peek_counting_context : percy::incremental_context {
+  void examine(std::size_t extent) {
+    ++peeks;
+    incremental_context::examine(extent);
+  }
+};
+} // namespace
+
+TEST_CASE("Push parser completes once the fragments complete the rule.", "[push_parser]") {
+  percy::push_parser<bracketed> parser;
+
+  REQUIRE(!parser.feed("[1"));
+  REQUIRE(!parser.feed("2"));
+  REQUIRE(parser.feed("3][4"));
+  REQUIRE(parser.result().is_success());
+  REQUIRE(parser.result()->end() == 5);
+  REQUIRE(std::get<1>(parser.result()->get()) == std::vector<char>{'1', '2', '3'});
+
+  REQUIRE(!parser.next());
+  REQUIRE(parser.feed("]"));
+  REQUIRE(parser.result()->end() == 3);
+}
+
+TEST_CASE("Push parser completes failures that no input could fix.", "[push_parser]") {
+  percy::push_parser<bracketed> parser;
+
+  REQUIRE(!parser.feed("[1"));
+  REQUIRE(parser.feed("x"));
+  REQUIRE(parser.result().is_failure());
+  REQUIRE(parser.result().failure().loc() == 2);
+}
+
+TEST_CASE("Push parser completes rules depending on the input end on finish.", "[push_parser]") {
+  percy::push_parser<percy::many<percy::range<'0', '9'>>> parser;
+
+  REQUIRE(!parser.feed("12"));
+  REQUIRE(!parser.feed("34"));
+  REQUIRE(parser.finish().is_success());
+  REQUIRE(parser.result()->get().size() == 4);
+}
+
+TEST_CASE("Push parser reuses memoized results of previous fragments.", "[push_parser]") {
+  percy::push_parser<items> parser;
+
+  item_calls = 0;
+
+  for (std::string_view fragment : {"a", ";", "b;", "c;d", ";"}) {
+    REQUIRE(!parser.feed(fragment));
+  }
+
+  REQUIRE(parser.feed("."));
+  REQUIRE(parser.result()->end() == 9);
+  REQUIRE(std::get<0>(parser.result()->get()) == std::vector<char>{'a', 'b', 'c', 'd'});
+  REQUIRE(item_calls == 4);
+}
+
+TEST_CASE("Push parser resumes repetitions after their completed items.", "[push_parser]") {
+  using unmemoized = percy::sequence<percy::many<item>, percy::symbol<'.'>>;
+
+  STATIC_REQUIRE(std::is_same_v<percy::resumable_item_t<unmemoized>, item>);
+  STATIC_REQUIRE(std::is_same_v<percy::resumable_item_t<bracketed>, percy::range<'0', '9'>>);
+  STATIC_REQUIRE(std::is_same_v<percy::resumable_item_t<tagged>, item>);
+  STATIC_REQUIRE(std::is_same_v<percy::resumable_item_t<percy::symbol<'a'>>, void>);
+
+  percy::push_parser<unmemoized, peek_counting_context> parser;
+
+  item_calls = 0;
+  peeks = 0;
+
+  for (std::size_t i = 0; i < 1000; ++i) {
+    REQUIRE(!parser.feed("a"));
+    REQUIRE(!parser.feed(";"));
+  }
+
+  // Parsing the buffered input again on each fragment would examine it about a million times.
+  // Items are parsed again only when the growing buffer moves.
+  REQUIRE(peeks < 50000);
+  REQUIRE(item_calls < 3000);
+
+  auto calls = item_calls;
+
+  REQUIRE(parser.feed("."));
+  REQUIRE(parser.result()->end() == 2001);
+  REQUIRE(std::get<0>(parser.result()->get()).size() == 1000);
+  REQUIRE(item_calls == calls);
+
+  REQUIRE(!parser.next());
+  REQUIRE(!parser.feed("b;"));
+  REQUIRE(parser.feed("."));
+  REQUIRE(std::get<0>(parser.result()->get()) == std::vector<char>{'b'});
+}
+
+TEST_CASE("Push parser resumes repetitions following other rules.", "[push_parser]") {
+  percy::push_parser<tagged, peek_counting_context> parser;
+
+  peeks = 0;
+
+  REQUIRE(!parser.feed("<"));
+
+  for (std::size_t i = 0; i < 1000; ++i) {
+    REQUIRE(!parser.feed("a;"));
+  }
+
+  REQUIRE(peeks < 50000);
+  REQUIRE(parser.feed(">"));
+  REQUIRE(parser.result()->end() == 2002);
+  REQUIRE(parser.result()->get() == 1000);
+
+  // Failures are the same as those of parsing the whole text.
+  percy::incremental_context ctx;
+  auto direct = percy::parser<tagged>::parse(
+      percy::with_incremental_context(percy::input("<a;b>"), ctx));
+
+  REQUIRE(!parser.next());
+  REQUIRE(parser.feed("<a;b>"));
+  REQUIRE(parser.result().is_failure());
+  REQUIRE(parser.result().failure().loc() == direct.failure().loc().get());
+}
@@ -4,4 +4,77 @@
 
 #include <percy/result.hpp>
 
-//
+TEST_CASE("Recognize keeps the span of a success.", "[result][recognize]") {
+  PERCY_CONSTEXPR auto result =
+      percy::recognize(percy::result<int>(percy::succeed(42, {percy::input_location(1), 2})));
+
+  STATIC_REQUIRE(result.is_success());
+  STATIC_REQUIRE(result->begin() == 1);
+  STATIC_REQUIRE(result->end() == 3);
+}
+
+TEST_CASE("Recognize keeps the location of a failure.", "[result][recognize]") {
+  PERCY_CONSTEXPR auto result =
+      percy::recognize(percy::result<int>(percy::fail("Failure.", percy::input_location(4))));
+
+  STATIC_REQUIRE(result.is_failure());
+  STATIC_REQUIRE(result.failure().loc() == 4);
+}
+
+TEST_CASE("Failures stay as small as a message and a location.", "[result]") {
+  STATIC_REQUIRE(sizeof(percy::failure_t) == sizeof(std::string_view) + sizeof(std::size_t));
+}
+
+TEST_CASE("Committed failures keep their location.", "[result][commit]") {
+  PERCY_CONSTEXPR auto failure = percy::fail("Failure.", percy::input_location(7)).commit();
+
+  STATIC_REQUIRE(failure.committed());
+  STATIC_REQUIRE(failure.loc() == 7);
+  STATIC_REQUIRE(!percy::fail("Failure.", percy::input_location(7)).committed());
+}
+
+TEST_CASE("Furthest keeps the failure further into the input.", "[result][furthest]") {
+  PERCY_CONSTEXPR auto near = percy::fail("Near.", percy::input_location(1));
+  PERCY_CONSTEXPR auto far = percy::fail("Far.", percy::input_location(2));
+  PERCY_CONSTEXPR auto other = percy::fail("Other.", percy::input_location(2));
+
+  STATIC_REQUIRE(percy::furthest(near, far).message() == "Far.");
+  STATIC_REQUIRE(percy::furthest(far, near).message() == "Far.");
+  STATIC_REQUIRE(percy::furthest(far, other).message() == "Far.");
+}
+
+TEST_CASE("Expectations keep the descriptions at the furthest location.",
+          "[result][expectations]") {
+  PERCY_CONSTEXPR auto expected = [] {
+    percy::expectations expected;
+    expected.record(percy::input_location(2), "a");
+    expected.record(percy::input_location(3), "b");
+    expected.record(percy::input_location(1), "c");
+    expected.record(percy::input_location(3), "d");
+    expected.record(percy::input_location(3), "b");
+    return expected;
+  }();
+
+  STATIC_REQUIRE(expected.loc() == 3);
+  STATIC_REQUIRE(expected.size() == 2);
+  STATIC_REQUIRE(expected.contains("b"));
+  STATIC_REQUIRE(expected.contains("d"));
+  STATIC_REQUIRE(!expected.contains("a"));
+}
+
+TEST_CASE("Expectations keep at most their capacity.", "[result][expectations]") {
+  PERCY_CONSTEXPR auto expected = [] {
+    constexpr std::string_view letters = "abcdefghijklmnop";
+    percy::expectations expected;
+
+    for (std::size_t i = 0; i < letters.size(); ++i) {
+      expected.insert(letters.substr(i, 1));
+    }
+
+    return expected;
+  }();
+
+  STATIC_REQUIRE(expected.size() == percy::expectations::capacity);
+  STATIC_REQUIRE(expected.contains("a"));
+  STATIC_REQUIRE(!expected.contains("p"));
+}
@@ -0,0 +1,60 @@
+#include "testing.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <percy/scan.hpp>
+
+#include <percy/input.hpp>
+#include <percy/parser.hpp>
+
+#include <string>
+
+using digit = percy::range<'0', '9'>;
+using identifier_char =
+    percy::either<percy::range<'a', 'z'>, percy::range<'A', 'Z'>, percy::symbol<'_'>>;
+
+TEST_CASE("Character classes are recognized.", "[scan][char_class]") {
+  STATIC_REQUIRE(percy::is_char_class_v<percy::symbol<'a'>>);
+  STATIC_REQUIRE(percy::is_char_class_v<digit>);
+  STATIC_REQUIRE(percy::is_char_class_v<identifier_char>);
+
+  STATIC_REQUIRE_FALSE(percy::is_char_class_v<percy::end>);
+  STATIC_REQUIRE_FALSE(percy::is_char_class_v<percy::sequence<percy::symbol<'a'>>>);
+  STATIC_REQUIRE_FALSE(percy::is_char_class_v<percy::either<digit, percy::end>>);
+}
+
+TEST_CASE("Scan stops at the first unmatched character.", "[scan]") {
+  STATIC_REQUIRE(percy::scan<digit>("") == 0);
+  STATIC_REQUIRE(percy::scan<digit>("x12") == 0);
+  STATIC_REQUIRE(percy::scan<digit>("123x4") == 3);
+  STATIC_REQUIRE(percy::scan<identifier_char>("Ab_c9") == 4);
+}
+
+TEST_CASE("Scan gives the same results at run-time for every run length.", "[scan]") {
+  for (std::size_t length = 0; length < 100; ++length) {
+    auto text = std::string(length, '7') + "x" + std::string(40, '1');
+
+    REQUIRE(percy::scan<digit>(text) == length);
+    REQUIRE(percy::scan<digit>(std::string_view(text).substr(0, length)) == length);
+  }
+}
+
+TEST_CASE("Scan handles characters outside of the ASCII range.", "[scan]") {
+  using high = percy::either<percy::symbol<'\x80'>, percy::symbol<'\x90'>>;
+
+  auto text = std::string(37, '\x90') + "\x80\x7f";
+
+  REQUIRE(percy::scan<high>(text) == 38);
+}
+
+TEST_CASE("Parser many consumes character runs in bulk.", "[scan][parser][many]") {
+  using parser = percy::parser<percy::many<identifier_char>>;
+
+  auto text = std::string(70, 'a') + "_Z" + "-rest";
+  auto result = parser::parse(percy::input(text, 1));
+
+  REQUIRE(result.is_success());
+  REQUIRE(result->begin() == 1);
+  REQUIRE(result->end() == 72);
+  REQUIRE(result->get() == std::vector<char>(text.begin() + 1, text.begin() + 72));
+}
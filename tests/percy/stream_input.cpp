@@ -0,0 +1,181 @@
+#include "testing.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <percy/parser.hpp>
+#include <percy/stream_input.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace {
+/// Reader handing out the text in pieces, remembering the most the stream has ever buffered.
+struct text_reader {
+  std::string text;
+  std::size_t offset = 0;
+  const percy::stream *stream = nullptr;
+  std::size_t peak_buffered = 0;
+
+  std::size_t operator()(char *buffer, std::size_t size) {
+    if (stream != nullptr) {
+      peak_buffered = std::max(peak_buffered, stream->buffered());
+    }
+
+    auto count = std::min(size, text.size() - offset);
+    std::memcpy(buffer, text.data() + offset, count);
+    offset += count;
+    return count;
+  }
+};
+
+struct abcdef {
+  constexpr static std::string_view string = "abcdef";
+};
+
+struct abcdefy {
+  constexpr static std::string_view string = "abcdefy";
+};
+
+struct count {
+  std::size_t operator()() const { return 0; }
+  std::size_t operator()(std::size_t total, char) const { return total + 1; }
+};
+
+using xs = percy::fold_many<percy::symbol<'x'>, count, count>;
+
+struct document {
+  using rule = percy::sequence<xs, percy::end>;
+
+  static std::size_t action(std::size_t total, percy::eof) { return total; }
+};
+} // namespace
+
+TEST_CASE("Stream input reads across chunks.", "[inputs][stream_input]") {
+  text_reader reader{"abc"};
+  percy::stream stream(std::ref(reader), 2);
+
+  auto input = stream.input();
+
+  REQUIRE(!input.ended());
+  REQUIRE(input.loc() == 0);
+  REQUIRE(input.peek() == 'a');
+  REQUIRE(input.advanced_by(1).peek() == 'b');
+  REQUIRE(input.advanced_by(2).peek() == 'c');
+  REQUIRE(input.advanced_to(percy::input_location(2)).loc() == 2);
+  REQUIRE(input.advanced_by(3).ended());
+}
+
+TEST_CASE("Empty stream input is ended.", "[inputs][stream_input]") {
+  text_reader reader{""};
+  percy::stream stream(std::ref(reader));
+
+  REQUIRE(stream.input().ended());
+  REQUIRE(stream.input().loc() == 0);
+}
+
+TEST_CASE("Parsers backtrack across chunks of stream input.", "[inputs][stream_input]") {
+  using rule = percy::either<percy::word<abcdef>, percy::word<abcdefy>>;
+  using parser = percy::parser<percy::sequence<rule, percy::symbol<'!'>>>;
+
+  text_reader reader{"abcdefy!"};
+  percy::stream stream(std::ref(reader), 2);
+
+  auto result = parser::parse(stream.input());
+
+  REQUIRE(result.is_failure());
+
+  text_reader other_reader{"abcdef!"};
+  percy::stream other_stream(std::ref(other_reader), 2);
+
+  auto other_result = parser::parse(other_stream.input());
+
+  REQUIRE(other_result.is_success());
+  REQUIRE(other_result->end() == 7);
+}
+
+TEST_CASE("Stream input discards chunks no input can reach.", "[inputs][stream_input]") {
+  using parser = percy::parser<percy::fold_many<percy::symbol<'x'>, count, count>>;
+
+  text_reader reader{std::string(1 << 16, 'x')};
+  percy::stream stream(std::ref(reader), 64);
+  reader.stream = &stream;
+
+  auto result = parser::parse(stream.input());
+
+  REQUIRE(result.is_success());
+  REQUIRE(result->get() == 1 << 16);
+  REQUIRE(reader.peak_buffered <= 2 * 64);
+  REQUIRE(stream.buffered() == 0);
+}
+
+TEST_CASE("Stream input discards chunks under sequences and custom rules.",
+          "[inputs][stream_input]") {
+  text_reader reader{std::string(1 << 16, 'x')};
+  percy::stream stream(std::ref(reader), 64);
+  reader.stream = &stream;
+
+  auto result = percy::parser<percy::sequence<xs, percy::end>>::parse(stream.input());
+
+  REQUIRE(result.is_success());
+  REQUIRE(std::get<0>(result->get()) == 1 << 16);
+  REQUIRE(reader.peak_buffered <= 2 * 64);
+
+  text_reader document_reader{std::string(1 << 16, 'x')};
+  percy::stream document_stream(std::ref(document_reader), 64);
+  document_reader.stream = &document_stream;
+
+  auto parsed = percy::parser<document>::parse(document_stream.input());
+
+  REQUIRE(parsed.is_success());
+  REQUIRE(parsed->get() == 1 << 16);
+  REQUIRE(document_reader.peak_buffered <= 2 * 64);
+}
+
+TEST_CASE("Stream input discards chunks before commits of enclosing rules.",
+          "[inputs][stream_input][commit]") {
+  using committed = percy::sequence<percy::symbol<'x'>, percy::commit, xs, percy::end>;
+  using other = percy::sequence<percy::symbol<'y'>, xs, percy::end>;
+  using parser = percy::parser<percy::either<committed, other>>;
+
+  text_reader reader{std::string(1 << 16, 'x')};
+  percy::stream stream(std::ref(reader), 64);
+  reader.stream = &stream;
+
+  auto result = parser::parse(stream.input());
+
+  REQUIRE(result.is_success());
+  REQUIRE(std::get<1>(result->get()) == (1 << 16) - 1);
+  REQUIRE(reader.peak_buffered <= 2 * 64);
+  REQUIRE(stream.buffered() == 0);
+
+  // Without the commit, the choice keeps the chunks it could backtrack to.
+  using uncommitted = percy::sequence<percy::symbol<'x'>, xs, percy::end>;
+
+  text_reader other_reader{std::string(1 << 16, 'x')};
+  percy::stream other_stream(std::ref(other_reader), 64);
+  other_reader.stream = &other_stream;
+
+  auto other_result = percy::parser<percy::either<uncommitted, other>>::parse(other_stream.input());
+
+  REQUIRE(other_result.is_success());
+  REQUIRE(other_reader.peak_buffered == 1 << 16);
+}
+
+#if __has_include(<unistd.h>)
+TEST_CASE("Stream input reads file descriptors.", "[inputs][stream_input]") {
+  int descriptors[2];
+  REQUIRE(::pipe(descriptors) == 0);
+  REQUIRE(::write(descriptors[1], "xyz", 3) == 3);
+  ::close(descriptors[1]);
+
+  auto stream = percy::stream::from_descriptor(descriptors[0], 2);
+  auto result = percy::parser<percy::many<percy::range<'x', 'z'>>>::parse(stream.input());
+
+  ::close(descriptors[0]);
+
+  REQUIRE(result.is_success());
+  REQUIRE(result->end() == 3);
+}
+#endif
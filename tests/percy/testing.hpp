@@ -143,7 +143,7 @@ struct event {
 };
 
 struct event_log {
-  std::array<event, 64> events;
+  std::array<event, 256> events;
   std::size_t cursor;
 
   constexpr event_log() : events(), cursor(0) {}
@@ -160,6 +160,26 @@ struct event_log {
     return cursor;
   }
 
+  constexpr std::size_t count(event::event_type_ids id) const {
+    std::size_t result = 0;
+
+    for (std::size_t i = 0; i < size(); ++i) {
+      if ((*this)[i].event_type_id == id) {
+        ++result;
+      }
+    }
+
+    return result;
+  }
+
+  constexpr std::size_t copies() const {
+    return count(event::event_type_ids::cc) + count(event::event_type_ids::ca);
+  }
+
+  constexpr std::size_t moves() const {
+    return count(event::event_type_ids::mc) + count(event::event_type_ids::ma);
+  }
+
   constexpr bool operator==(const event_log& other) const {
     if (size() != other.size()) {
       return false;
@@ -178,7 +198,7 @@ struct event_log {
 struct context {
   event_log events;
 
-  std::array<std::pair<const void*, tracker_id>, 64> ptr_id_map;
+  std::array<std::pair<const void*, tracker_id>, 256> ptr_id_map;
   std::size_t ptr_id_count;
   std::size_t highest_id;
 
@@ -282,6 +302,9 @@ struct tracker2 : public tracker1 {
   constexpr explicit tracker2(context& context) : tracker1(context) {}
 };
 
+/// Rule producing a tracker registered in the context of the input, failing on ended input.
+struct tracked {};
+
 template <typename Function>
 constexpr event_log capture_events(Function&& function) {
   context ctx;
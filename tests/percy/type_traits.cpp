@@ -54,3 +54,11 @@ TEST_CASE("Trait type_index returns correct indices.", "[type_traits]") {
   STATIC_REQUIRE(percy::type_index_v<bool, char, bool, char> == 1);
   STATIC_REQUIRE(percy::type_index_v<bool, char, char, bool, char> == 2);
 }
+
+TEST_CASE("Trait at_index returns types at correct indices.", "[type_traits]") {
+  STATIC_REQUIRE(std::is_same_v<percy::at_index_t<0, bool>, bool>);
+  STATIC_REQUIRE(std::is_same_v<percy::at_index_t<0, bool, char, int>, bool>);
+  STATIC_REQUIRE(std::is_same_v<percy::at_index_t<1, bool, char, int>, char>);
+  STATIC_REQUIRE(std::is_same_v<percy::at_index_t<2, bool, char, int>, int>);
+  STATIC_REQUIRE(std::is_same_v<percy::at_index_t<1, bool, bool, bool>, bool>);
+}
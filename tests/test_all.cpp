@@ -71,18 +71,26 @@ TEST_CASE("It parses nested parentheses correctly.", "[example]") {
 
 TEST_CASE("It fails to parse unbalanced parentheses.", "[example]") {
   using parser = percy::parser<grammar::paren>;
-  auto input = percy::input("({}");
+  percy::context ctx;
+  auto input = percy::with_context(percy::input("({}"), ctx);
   auto result = parser::parse(input);
 
   REQUIRE(result.is_failure());
-  REQUIRE(result.failure().loc() == 0);
+  REQUIRE(result.failure().loc() == 3);
+  REQUIRE(ctx.expected().loc() == 3);
+  REQUIRE(ctx.expected().contains(")"));
 }
 
 TEST_CASE("It fails to parse mismatched parentheses.", "[example]") {
   using parser = percy::parser<grammar::paren>;
-  auto input = percy::input("({))");
+  percy::context ctx;
+  auto input = percy::with_context(percy::input("({))"), ctx);
   auto result = parser::parse(input);
 
   REQUIRE(result.is_failure());
-  REQUIRE(result.failure().loc() == 0);
+
+  // The curly parenthesis failed further, even though the repetition absorbed its failure.
+  REQUIRE(result.failure().loc() == 2);
+  REQUIRE(ctx.expected().loc() == 2);
+  REQUIRE(ctx.expected().contains("}"));
 }